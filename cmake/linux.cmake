@@ -4,7 +4,6 @@ find_package(SDL3 REQUIRED)
 
 add_executable(${PROJECT_NAME}
         src/main.cpp
-        src/config/convert_custom.cpp
 )
 
 target_include_directories(${PROJECT_NAME} PUBLIC
@@ -15,3 +14,50 @@ target_link_libraries(${PROJECT_NAME} PRIVATE
     image_data
     SDL3::SDL3)
 
+
+# reference viewer of the shared memory display
+add_executable(${PROJECT_NAME}_shm_viewer
+        src/shm_viewer.cpp
+)
+
+target_include_directories(${PROJECT_NAME}_shm_viewer PUBLIC
+        ${CMAKE_CURRENT_SOURCE_DIR}/src
+)
+
+target_compile_definitions(${PROJECT_NAME}_shm_viewer PUBLIC PICON_PLATFORM_LINUX)
+
+set_target_properties(${PROJECT_NAME}_shm_viewer PROPERTIES
+        C_STANDARD 11
+        CXX_STANDARD 23)
+
+target_link_libraries(${PROJECT_NAME}_shm_viewer PRIVATE
+    SDL3::SDL3)
+
+
+# host tests, each an executable that returns non-zero on a failed check
+enable_testing()
+
+set(PICON_TESTS
+        async_runtime
+        sh1122_mock
+        memory
+)
+
+foreach(test ${PICON_TESTS})
+        add_executable(${PROJECT_NAME}_test_${test}
+                tests/${test}.cpp
+        )
+
+        target_include_directories(${PROJECT_NAME}_test_${test} PUBLIC
+                ${CMAKE_CURRENT_SOURCE_DIR}/src
+                ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        )
+
+        target_compile_definitions(${PROJECT_NAME}_test_${test} PUBLIC PICON_PLATFORM_LINUX)
+
+        set_target_properties(${PROJECT_NAME}_test_${test} PROPERTIES
+                C_STANDARD 11
+                CXX_STANDARD 23)
+
+        add_test(NAME ${test} COMMAND ${PROJECT_NAME}_test_${test})
+endforeach()
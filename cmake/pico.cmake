@@ -8,7 +8,6 @@ pico_sdk_init()
 
 add_executable(${PROJECT_NAME}
         src/main.cpp
-        src/config/convert_custom.cpp
         src/pal/pico/getentropy.cpp
 )
 
@@ -19,6 +18,7 @@ target_include_directories(${PROJECT_NAME} PUBLIC
 # target_compile_options(${PROJECT_NAME} PRIVATE -fPIC)
 
 target_link_libraries(${PROJECT_NAME} PRIVATE
+        hardware_divider
         hardware_dma
         hardware_flash
         hardware_interp
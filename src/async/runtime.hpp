@@ -0,0 +1,276 @@
+#pragma once
+
+#include "task.hpp"
+
+#include "time/time.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace picon::async
+{
+
+    /// single threaded executor for Task coroutines.
+    /// driven from the main loop by run(), and by frame() once per display frame.
+    /// signal() is the only member safe to call from interrupts and other threads.
+    struct Runtime
+    {
+    public:
+        /// time source for sleepUs, swap in VirtualClock::now to test without waiting.
+        std::uint64_t (*clock)() = time::getEpochTimeUs64;
+
+    private:
+        using Waiter = internal::Waiter;
+
+        Waiter* ready_head{};
+        Waiter* ready_tail{};
+        /// sorted by wake_us.
+        Waiter* timers{};
+        Waiter* frame_waiters{};
+        /// woken by signal(), each checked with its is_ready on the next run().
+        Waiter* signal_waiters{};
+        std::atomic<bool> signalled{false};
+
+        std::uint64_t frame_delta_us{};
+
+    public:
+        /// take ownership of p_task and queue it to start on the next run().
+        void spawn(Task<>&& p_task)
+        {
+            if (!p_task.valid()) { return; }
+
+            const auto handle = std::exchange(p_task.handle, {});
+            auto& promise = handle.promise();
+            promise.runtime = this;
+            promise.detached = true;
+            promise.node.handle = handle;
+            schedule(promise.node);
+        }
+
+        /// resume everything that became ready: expired timers, signalled waiters and spawned tasks.
+        void run()
+        {
+            const auto now = clock();
+            while (timers != nullptr && timers->wake_us <= now)
+            {
+                schedule(*std::exchange(timers, timers->next));
+            }
+
+            // cleared before the checks, a completion racing them signals again.
+            if (signalled.exchange(false, std::memory_order_acq_rel))
+            {
+                for (auto link = &signal_waiters; *link != nullptr;)
+                {
+                    auto& waiter = **link;
+                    if (waiter.is_ready(waiter.context))
+                    {
+                        *link = waiter.next;
+                        schedule(waiter);
+                    }
+                    else
+                    {
+                        link = &waiter.next;
+                    }
+                }
+            }
+
+            resumeReady();
+        }
+
+        /// mark that a signal waiter may be ready, e.g. from a transfer completion interrupt.
+        /// only sets a flag, the waiters are checked by the next run().
+        void signal()
+        {
+            signalled.store(true, std::memory_order_release);
+        }
+
+        /// resume tasks waiting on nextFrame, p_delta_us is returned by their co_await.
+        void frame(std::uint64_t p_delta_us)
+        {
+            frame_delta_us = p_delta_us;
+            for (auto waiter = std::exchange(frame_waiters, nullptr); waiter != nullptr;)
+            {
+                schedule(*std::exchange(waiter, waiter->next));
+            }
+            run();
+        }
+
+        /// earliest time run() has work, now once signalled.
+        /// waiters on a signal alone don't keep the loop awake.
+        std::uint64_t getNextWakeUs() const
+        {
+            if (ready_head != nullptr || signalled.load(std::memory_order_acquire)) { return clock(); }
+            if (timers != nullptr) { return timers->wake_us; }
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+
+        const std::uint64_t& getFrameDelta() const
+        {
+            return frame_delta_us;
+        }
+
+        void schedule(Waiter& r_waiter)
+        {
+            r_waiter.next = nullptr;
+            if (ready_tail != nullptr) { ready_tail->next = &r_waiter; }
+            else { ready_head = &r_waiter; }
+            ready_tail = &r_waiter;
+        }
+
+        void addTimer(Waiter& r_waiter)
+        {
+            auto link = &timers;
+            while (*link != nullptr && (*link)->wake_us <= r_waiter.wake_us)
+            {
+                link = &(*link)->next;
+            }
+            r_waiter.next = *link;
+            *link = &r_waiter;
+        }
+
+        void addFrameWaiter(Waiter& r_waiter)
+        {
+            r_waiter.next = frame_waiters;
+            frame_waiters = &r_waiter;
+        }
+
+        void addSignalWaiter(Waiter& r_waiter)
+        {
+            r_waiter.next = signal_waiters;
+            signal_waiters = &r_waiter;
+        }
+
+    private:
+        void resumeReady()
+        {
+            while (ready_head != nullptr)
+            {
+                auto& waiter = *std::exchange(ready_head, ready_head->next);
+                if (ready_head == nullptr) { ready_tail = nullptr; }
+                waiter.handle.resume();
+            }
+        }
+    };
+
+
+    /// manually advanced clock for host tests of timing dependent tasks.
+    struct VirtualClock
+    {
+        static inline std::uint64_t now_us{};
+
+        static std::uint64_t now() { return now_us; }
+        static void advance(std::uint64_t p_us) { now_us += p_us; }
+    };
+
+
+    namespace internal
+    {
+        template <typename T_Promise>
+        concept RuntimePromise = std::derived_from<T_Promise, PromiseBase>;
+
+        struct FrameAwaiter
+        {
+            Waiter node{};
+            Runtime* runtime{};
+
+            bool await_ready() const noexcept { return false; }
+
+            template <RuntimePromise T_Promise>
+            void await_suspend(std::coroutine_handle<T_Promise> p_handle) noexcept
+            {
+                runtime = p_handle.promise().runtime;
+                node.handle = p_handle;
+                runtime->addFrameWaiter(node);
+            }
+
+            std::uint64_t await_resume() const noexcept { return runtime->getFrameDelta(); }
+        };
+
+        struct SleepAwaiter
+        {
+            std::uint64_t duration_us;
+            Waiter node{};
+
+            bool await_ready() const noexcept { return duration_us == 0; }
+
+            template <RuntimePromise T_Promise>
+            void await_suspend(std::coroutine_handle<T_Promise> p_handle) noexcept
+            {
+                auto& runtime = *p_handle.promise().runtime;
+                node.handle = p_handle;
+                node.wake_us = runtime.clock() + duration_us;
+                runtime.addTimer(node);
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        template <typename T_Driver>
+        struct TransferAwaiter
+        {
+            T_Driver* driver;
+            Waiter node{};
+
+            bool await_ready() const { return driver->isTransferDone(); }
+
+            template <RuntimePromise T_Promise>
+            void await_suspend(std::coroutine_handle<T_Promise> p_handle) noexcept
+            {
+                // without a bound completion nothing would ever signal, see bindTransferDone.
+                assert(driver->on_transfer_done != nullptr);
+                node.handle = p_handle;
+                node.is_ready = [](void* p_context){ return static_cast<T_Driver*>(p_context)->isTransferDone(); };
+                node.context = driver;
+                p_handle.promise().runtime->addSignalWaiter(node);
+            }
+
+            void await_resume() const noexcept {}
+        };
+    } // namespace internal
+
+    /// suspend until the next Runtime::frame(), returns that frame's delta in microseconds.
+    inline internal::FrameAwaiter nextFrame()
+    {
+        return {};
+    }
+
+    /// suspend for at least p_duration_us of the runtime clock.
+    inline internal::SleepAwaiter sleepUs(std::uint64_t p_duration_us)
+    {
+        return {p_duration_us};
+    }
+
+    /// a display driver whose transfers complete asynchronously.
+    /// on_transfer_done(on_transfer_done_context) is called from the completion,
+    /// an interrupt or another thread, whenever isTransferDone may have become true.
+    template <typename T_Driver>
+    concept TransferDriver = requires(T_Driver& r_driver)
+    {
+        { r_driver.isTransferDone() } -> std::convertible_to<bool>;
+        r_driver.on_transfer_done = static_cast<void(*)(void*)>(nullptr);
+        r_driver.on_transfer_done_context = static_cast<void*>(nullptr);
+    };
+
+    /// route the transfer completions of r_driver to r_runtime.signal().
+    /// call once before r_driver.init(), the completion reads these unsynchronized.
+    template <TransferDriver T_Driver>
+    inline void bindTransferDone(Runtime& r_runtime, T_Driver& r_driver)
+    {
+        r_driver.on_transfer_done = [](void* p_runtime){ static_cast<Runtime*>(p_runtime)->signal(); };
+        r_driver.on_transfer_done_context = &r_runtime;
+    }
+
+    /// suspend until p_driver can take another frame.
+    /// checked when its completion signals the runtime, see bindTransferDone.
+    template <TransferDriver T_Driver>
+    inline internal::TransferAwaiter<T_Driver> transferDone(T_Driver& p_driver)
+    {
+        return {&p_driver};
+    }
+
+} // namespace picon::async
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "memory/pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if !defined(PICON_ASYNC_FRAME_SIZE)
+#define PICON_ASYNC_FRAME_SIZE 256
+#endif
+
+#if !defined(PICON_ASYNC_NUM_FRAMES)
+#define PICON_ASYNC_NUM_FRAMES 16
+#endif
+
+namespace picon::async
+{
+
+    /// coroutine frames come from a fixed size block pool.
+    /// not thread safe, all tasks of a pool must live on one thread.
+    template <std::size_t t_block_size, std::size_t t_num_blocks>
+    using FramePool = memory::BlockPool<t_block_size, t_num_blocks>;
+
+    inline constinit FramePool<PICON_ASYNC_FRAME_SIZE, PICON_ASYNC_NUM_FRAMES> frame_pool{};
+
+
+    struct Runtime;
+
+    namespace internal
+    {
+        /// intrusive list node for a suspended coroutine, lives in the awaiter or promise.
+        struct Waiter
+        {
+            Waiter* next{};
+            std::coroutine_handle<> handle{};
+            std::uint64_t wake_us{};
+            bool (*is_ready)(void*){};
+            void* context{};
+        };
+
+        struct PromiseBase
+        {
+            Runtime* runtime{};
+            std::coroutine_handle<> continuation{};
+            /// spawned root task, frees itself on completion.
+            bool detached{};
+            Waiter node{};
+
+            static void* operator new(std::size_t p_size) noexcept
+            {
+                return frame_pool.allocate(p_size);
+            }
+
+            static void operator delete(void* p_ptr) noexcept
+            {
+                frame_pool.deallocate(p_ptr);
+            }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename T_Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<T_Promise> p_handle) noexcept
+                {
+                    auto& promise = p_handle.promise();
+                    if (promise.detached)
+                    {
+                        p_handle.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (promise.continuation) { return promise.continuation; }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() const noexcept { std::abort(); }
+        };
+
+        template <typename T_Value>
+        struct PromiseValue
+        {
+            std::optional<T_Value> value{};
+
+            void return_value(T_Value p_value) { value.emplace(std::move(p_value)); }
+        };
+
+        template <>
+        struct PromiseValue<void>
+        {
+            void return_void() const noexcept {}
+        };
+    } // namespace internal
+
+
+    /// lazily started coroutine, frames come from frame_pool.
+    /// if the pool is exhausted the task is empty, see valid().
+    /// @tparam T_Value
+    template <typename T_Value = void>
+    struct [[nodiscard]] Task
+    {
+        struct promise_type: public internal::PromiseBase, public internal::PromiseValue<T_Value>
+        {
+            Task get_return_object() noexcept
+            {
+                return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            static Task get_return_object_on_allocation_failure() noexcept
+            {
+                return Task{};
+            }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Handle handle{};
+
+        Task() = default;
+        explicit Task(Handle p_handle) : handle{p_handle} {}
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task(Task&& p_other) noexcept : handle{std::exchange(p_other.handle, {})} {}
+        Task& operator=(Task&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                if (handle) { handle.destroy(); }
+                handle = std::exchange(p_other.handle, {});
+            }
+            return *this;
+        }
+        ~Task()
+        {
+            if (handle) { handle.destroy(); }
+        }
+
+        bool valid() const { return static_cast<bool>(handle); }
+
+        struct Awaiter
+        {
+            Handle handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            template <typename T_Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<T_Promise> p_caller) noexcept
+            {
+                handle.promise().runtime = p_caller.promise().runtime;
+                handle.promise().continuation = p_caller;
+                return handle;
+            }
+
+            T_Value await_resume()
+            {
+                if constexpr (!std::is_void_v<T_Value>)
+                {
+                    assert(handle && handle.promise().value.has_value());
+                    return std::move(*handle.promise().value);
+                }
+            }
+        };
+
+        /// run as a child of the awaiting task, resumes the awaiter when done.
+        Awaiter operator co_await() && noexcept
+        {
+            return Awaiter{handle};
+        }
+    };
+
+} // namespace picon::async
@@ -0,0 +1,295 @@
+#pragma once
+
+#if defined(PICON_PLATFORM_LINUX)
+
+#include "graphics/color.hpp"
+#include "graphics/image.hpp"
+#include "time/time.hpp"
+#include "utils/bit_utils.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <type_traits>
+
+namespace picon::drivers
+{
+
+    /// records presented frames as a y4m stream, tagged with the capture time
+    /// of every frame so a capture doubles as a frame timing trace.
+    /// frames are converted straight into a memory mapped window of the file.
+    /// two windows form a ring: while one fills, the flusher thread writes the
+    /// other back and maps it at the next free part of the file, so push
+    /// never makes a syscall. when the flusher falls behind frames are dropped.
+    /// luminance and indexed formats are stored as mono, rgb formats as full range 4:4:4.
+    template <graphics::color::ColorType T_Color, std::size_t t_width, std::size_t t_height>
+    struct FrameCapture
+    {
+        static constexpr auto width = t_width;
+        static constexpr auto height = t_height;
+
+        static constexpr bool is_rgb =
+            T_Color::template has_channel<graphics::color::R> &&
+            T_Color::template has_channel<graphics::color::G> &&
+            T_Color::template has_channel<graphics::color::B>;
+
+        static constexpr std::size_t num_planes = is_rgb ? 3 : 1;
+
+        /// y4m frame header with an application parameter carrying the timestamp in us.
+        /// fixed width so every record has the same size.
+        static constexpr std::size_t frame_header_size = sizeof("FRAME Xts=00000000000000000000\n") - 1;
+        static constexpr std::size_t record_size = frame_header_size + width * height * num_planes;
+
+        /// frames per mapped window.
+        std::size_t frames_per_window{64};
+        /// frame rate in the stream header, for players. the timestamps don't depend on it.
+        std::size_t frame_rate{60};
+
+        std::size_t captured_frames{};
+        /// frames skipped because the next window wasn't mapped yet.
+        std::size_t dropped_frames{};
+        /// longest push, to keep the capture cost against the frame time in view.
+        std::uint64_t max_push_us{};
+
+    private:
+        enum class WindowState : std::uint8_t
+        {
+            ready,
+            full,
+            unmapped,
+        };
+
+        struct Window
+        {
+            std::uint8_t* map{};
+            std::size_t map_size{};
+            /// first record, map may start earlier to be page aligned.
+            std::uint8_t* records{};
+            std::size_t first_frame{};
+            std::size_t num_frames{};
+            std::atomic<WindowState> state{WindowState::unmapped};
+        };
+
+        int fd{-1};
+        std::size_t header_size{};
+        std::array<Window, 2> windows{};
+        std::size_t active_window{};
+
+        std::thread flusher{};
+        std::atomic<std::uint32_t> flush_requests{};
+        std::atomic<bool> flusher_running{false};
+
+    public:
+        FrameCapture() = default;
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        ~FrameCapture()
+        {
+            close();
+        }
+
+        bool isOpen() const
+        {
+            return fd >= 0;
+        }
+
+        /// create p_path and write the stream header, false with errno set on failure.
+        bool open(const char* p_path)
+        {
+            close();
+
+            active_window = 0;
+            captured_frames = 0;
+            dropped_frames = 0;
+            max_push_us = 0;
+
+            fd = ::open(p_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                std::perror("FrameCapture: open");
+                return false;
+            }
+
+            std::array<char, 128> header{};
+            const auto length = std::snprintf(
+                header.data(), header.size(),
+                "YUV4MPEG2 W%zu H%zu F%zu:1 Ip A1:1 %s XCOLORRANGE=FULL\n",
+                width, height, frame_rate, is_rgb ? "C444" : "Cmono");
+            header_size = static_cast<std::size_t>(length);
+
+            if (::write(fd, header.data(), header_size) != static_cast<ssize_t>(header_size) ||
+                !mapWindow(windows[0], 0) ||
+                !mapWindow(windows[1], frames_per_window))
+            {
+                std::perror("FrameCapture: open");
+                close();
+                return false;
+            }
+
+            flusher_running.store(true, std::memory_order_release);
+            flusher = std::thread{[this](){ flushLoop(); }};
+            return true;
+        }
+
+        /// append p_frame, stamped with the current time.
+        void push(const graphics::Image<T_Color>& p_frame)
+        {
+            if (!isOpen()) { return; }
+
+            const auto start = time::getEpochTimeUs64();
+
+            auto& window = windows[active_window];
+            if (window.state.load(std::memory_order_acquire) != WindowState::ready)
+            {
+                ++dropped_frames;
+                return;
+            }
+
+            auto record = window.records + window.num_frames * record_size;
+            std::snprintf(reinterpret_cast<char*>(record), frame_header_size + 1, "FRAME Xts=%020llu\n",
+                static_cast<unsigned long long>(start));
+            writePlanes(p_frame, record + frame_header_size);
+
+            ++captured_frames;
+            if (++window.num_frames == frames_per_window)
+            {
+                window.state.store(WindowState::full, std::memory_order_release);
+                flush_requests.fetch_add(1, std::memory_order_release);
+                flush_requests.notify_one();
+                active_window = (active_window + 1) % windows.size();
+            }
+
+            max_push_us = std::max(max_push_us, time::getEpochTimeUs64() - start);
+        }
+
+        /// stop the flusher and cut the file to the captured frames.
+        void close()
+        {
+            if (flusher.joinable())
+            {
+                flusher_running.store(false, std::memory_order_release);
+                flush_requests.fetch_add(1, std::memory_order_release);
+                flush_requests.notify_one();
+                flusher.join();
+            }
+
+            for (auto& window : windows)
+            {
+                unmapWindow(window);
+            }
+
+            if (fd >= 0)
+            {
+                if (::ftruncate(fd, header_size + captured_frames * record_size) != 0)
+                {
+                    std::perror("FrameCapture: close");
+                }
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+    private:
+        bool mapWindow(Window& r_window, std::size_t p_first_frame)
+        {
+            const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            const auto offset = header_size + p_first_frame * record_size;
+            const auto map_offset = offset / page_size * page_size;
+            const auto map_size = offset - map_offset + frames_per_window * record_size;
+
+            if (::ftruncate(fd, offset + frames_per_window * record_size) != 0) { return false; }
+
+            const auto map = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map_offset);
+            if (map == MAP_FAILED) { return false; }
+
+            // take the write faults here instead of in push.
+            for (std::size_t i = 0; i < map_size; i += page_size)
+            {
+                static_cast<volatile std::uint8_t*>(map)[i] = static_cast<volatile std::uint8_t*>(map)[i];
+            }
+
+            r_window.map = static_cast<std::uint8_t*>(map);
+            r_window.map_size = map_size;
+            r_window.records = r_window.map + (offset - map_offset);
+            r_window.first_frame = p_first_frame;
+            r_window.num_frames = 0;
+            r_window.state.store(WindowState::ready, std::memory_order_release);
+            return true;
+        }
+
+        void unmapWindow(Window& r_window)
+        {
+            if (r_window.map == nullptr) { return; }
+            ::msync(r_window.map, r_window.map_size, MS_SYNC);
+            ::munmap(r_window.map, r_window.map_size);
+            r_window.map = nullptr;
+            r_window.state.store(WindowState::unmapped, std::memory_order_release);
+        }
+
+        void flushLoop()
+        {
+            auto seen = flush_requests.load(std::memory_order_acquire);
+            while (true)
+            {
+                for (auto& window : windows)
+                {
+                    if (window.state.load(std::memory_order_acquire) != WindowState::full) { continue; }
+
+                    const auto next_frame = window.first_frame + windows.size() * frames_per_window;
+                    unmapWindow(window);
+                    if (!mapWindow(window, next_frame))
+                    {
+                        std::perror("FrameCapture: map");
+                    }
+                }
+
+                if (!flusher_running.load(std::memory_order_acquire)) { return; }
+                flush_requests.wait(seen, std::memory_order_acquire);
+                seen = flush_requests.load(std::memory_order_acquire);
+            }
+        }
+
+        static void writePlanes(const graphics::Image<T_Color>& p_frame, std::uint8_t* r_dst)
+        {
+            using namespace graphics::color;
+
+            if constexpr (is_rgb)
+            {
+                auto y_plane = r_dst;
+                auto u_plane = y_plane + width * height;
+                auto v_plane = u_plane + width * height;
+                for (const auto& pixel : p_frame)
+                {
+                    const std::int32_t r = utils::resizeBits<8, T_Color::template channel<R>.size>(pixel.template get<R>());
+                    const std::int32_t g = utils::resizeBits<8, T_Color::template channel<G>.size>(pixel.template get<G>());
+                    const std::int32_t b = utils::resizeBits<8, T_Color::template channel<B>.size>(pixel.template get<B>());
+                    // bt.601 full range, 8 fractional bits.
+                    *y_plane++ = static_cast<std::uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+                    *u_plane++ = static_cast<std::uint8_t>(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128);
+                    *v_plane++ = static_cast<std::uint8_t>(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128);
+                }
+            }
+            else
+            {
+                using Channel = std::conditional_t<T_Color::template has_channel<L>, L, I>;
+                for (const auto& pixel : p_frame)
+                {
+                    *r_dst++ = static_cast<std::uint8_t>(
+                        utils::resizeBits<8, T_Color::template channel<Channel>.size>(pixel.template get<Channel>()));
+                }
+            }
+        }
+    };
+
+} // namespace picon::drivers
+
+#endif
@@ -2,12 +2,18 @@
 
 #if defined(PICON_PLATFORM_LINUX)
 
+#include "drivers/capture.hpp"
 #include "graphics/color.hpp"
+#include "graphics/convert.hpp"
 #include "graphics/image.hpp"
+#include "graphics/instrument.hpp"
+#include "graphics/palette.hpp"
+#include "time/time.hpp"
 #include "utils/bit_utils.hpp"
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_error.h>
+#include <SDL3/SDL_events.h>
 #include <SDL3/SDL_init.h>
 #include <SDL3/SDL_log.h>
 #include <SDL3/SDL_oldnames.h>
@@ -15,10 +21,15 @@
 #include <SDL3/SDL_rect.h>
 #include <SDL3/SDL_render.h>
 #include <SDL3/SDL_surface.h>
+#include <SDL3/SDL_timer.h>
 #include <SDL3/SDL_video.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 
 namespace picon::drivers
@@ -30,10 +41,31 @@ namespace picon::drivers
         // static
         using FrameBufferData = graphics::ImageData<T_Color, t_width, t_height>;
         using FrameBuffer = graphics::Image<T_Color>;
+        using Capture = FrameCapture<T_Color, t_width, t_height>;
 
         constexpr static std::size_t width = t_width;
         constexpr static std::size_t height = t_height;
 
+        /// three buffers so the main thread can hold one on screen, the mailbox
+        /// one finished frame and the render thread one in progress.
+        constexpr static std::size_t num_frame_buffers = 3;
+
+        struct PresentStats
+        {
+            std::uint64_t frames{};
+            /// frames replaced in the mailbox before the main thread picked them up.
+            std::uint64_t dropped{};
+            /// upload and present of one frame, vsync wait included.
+            std::uint64_t present_us_sum{};
+            std::uint64_t present_us_max{};
+            /// swapBuffers to the start of the frame's upload.
+            std::uint64_t latency_us_sum{};
+            std::uint64_t latency_us_max{};
+
+            std::uint64_t getMeanPresentUs() const { return frames > 0 ? present_us_sum / frames : 0; }
+            std::uint64_t getMeanLatencyUs() const { return frames > 0 ? latency_us_sum / frames : 0; }
+        };
+
         static constexpr SDL_PixelFormat sdl_pixel_format = [](){
             if constexpr (std::same_as<T_Color, graphics::color::GS4>) { return SDL_PIXELFORMAT_INDEX8; }
             else if constexpr (std::same_as<T_Color, graphics::color::GS4A1>) { return SDL_PIXELFORMAT_INDEX8; }
@@ -42,21 +74,80 @@ namespace picon::drivers
             else if constexpr (std::same_as<T_Color, graphics::color::R4G4B4A4>) { return SDL_PIXELFORMAT_RGBA4444; }
             else if constexpr (std::same_as<T_Color, graphics::color::R8G8B8>) { return SDL_PIXELFORMAT_XRGB8888; }
             else if constexpr (std::same_as<T_Color, graphics::color::R8G8B8A8>) { return SDL_PIXELFORMAT_RGBA8888; }
+            else if constexpr (std::same_as<T_Color, graphics::color::I4>) { return SDL_PIXELFORMAT_INDEX8; }
+            else if constexpr (std::same_as<T_Color, graphics::color::I8>) { return SDL_PIXELFORMAT_INDEX8; }
             else { static_assert(false, "unsupported pixel format"); }
         }();
 
         // instance
         bool integer_scaling{false};
-        
-        std::array<FrameBufferData, 2> frame_buffer_data{};
-        std::array<FrameBuffer, 2> frame_buffers{ frame_buffer_data[0], frame_buffer_data[1], };
-        std::size_t front_buffer_idx{};
+
+        /// rasterize straight into the locked streaming texture instead of copying
+        /// a cpu frame buffer into it on every swap.
+        /// falls back to the copy path for software renderers, indexed formats,
+        /// use_render_thread and when the texture rows are padded.
+        bool use_locked_texture{true};
+
+        /// rasterize on a worker thread so it never blocks on vsync.
+        /// the renderer, uploads and presents stay on the main thread, which calls presentLatest().
+        /// the worker's swapBuffers hands finished frames over through a latest-frame-wins
+        /// mailbox, frames the main thread didn't pick up in time are dropped.
+        /// set before init.
+        bool use_render_thread{false};
+
+        /// called by presentLatest once it took a frame, on the main thread.
+        void (*on_transfer_done)(void* p_context){};
+        void* on_transfer_done_context{};
+
+        /// log the present stats this often, 0 to never.
+        std::uint64_t stats_log_interval_us{0};
+
+        std::array<FrameBufferData, num_frame_buffers> frame_buffer_data{};
+        std::array<FrameBuffer, num_frame_buffers> frame_buffers{ frame_buffer_data[0], frame_buffer_data[1], frame_buffer_data[2], };
+        std::size_t front_buffer_idx{0};
+        std::size_t back_buffer_idx{1};
+
+        /// every swapped frame is pushed here when set.
+        Capture* capture{};
+
+        #if defined(PICON_GRAPHICS_INSTRUMENT)
+        /// write counts of the frame being drawn.
+        graphics::instrument::OverdrawBuffer<t_width, t_height> overdraw{};
+
+        /// present the overdraw heatmap instead of the frame.
+        bool show_overdraw{false};
+        #endif
 
         SDL_Window* window{};
         SDL_Renderer* renderer{};
         bool use_frame_buffer_textures{true};
-        std::array<SDL_Surface*, 2> frame_buffer_surfaces{};
-        std::array<SDL_Texture*, 2> frame_buffer_textures{};
+        std::array<SDL_Surface*, num_frame_buffers> frame_buffer_surfaces{};
+        std::array<SDL_Texture*, num_frame_buffers> frame_buffer_textures{};
+        bool back_buffer_locked{false};
+
+        /// index of the latest finished frame, fresh_frame_bit set until the main thread takes it.
+        static constexpr std::uint8_t fresh_frame_bit = 0x80;
+        std::atomic<std::uint8_t> mailbox{0};
+        std::size_t present_buffer_idx{2};
+
+        /// when each buffer was swapped, written before it is posted to the mailbox.
+        std::array<std::uint64_t, num_frame_buffers> swapped_at_us{};
+        /// written by the render thread, copied into present_stats by the main thread.
+        std::atomic<std::uint64_t> dropped_frames{};
+        PresentStats present_stats{};
+        std::uint64_t stats_logged_at_us{};
+
+        /// palette colors travel with their frame buffer, staged by setPalette on the
+        /// render side and applied to sdl_palette by the main thread when the frame is presented.
+        struct FramePalette
+        {
+            std::array<SDL_Color, 256> colors{};
+            int num_colors{};
+            std::uint32_t version{};
+        };
+        FramePalette staged_palette{};
+        std::array<FramePalette, num_frame_buffers> frame_palettes{};
+        std::uint32_t applied_palette_version{};
 
         SDL_Palette* sdl_palette{};
 
@@ -76,33 +167,21 @@ namespace picon::drivers
                 abort();
             }
 
-            // try vulkan
-            renderer = SDL_CreateRenderer(window, "vulkan");
-            // fallback to default
-            if (renderer == nullptr)
-            {
-                renderer = SDL_CreateRenderer(window, nullptr);
-            }
-            // fail
-            if (renderer == nullptr)
-            {
-                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not create renderer: %s\n", SDL_GetError());
-                abort();
-            }
-
-            SDL_SetRenderVSync(renderer, 1);
-
-            if (std::string{SDL_GetRendererName(renderer)} == "software")
-            {
-                use_frame_buffer_textures = false;
-            }
-
-
             if constexpr (sdl_pixel_format == SDL_PIXELFORMAT_INDEX8)
             {
                 use_frame_buffer_textures = false;
 
-                constexpr auto num_bits = T_Color::template channel<graphics::color::L>.size;
+                // indexed formats start with a gray ramp until setPalette.
+                constexpr auto num_bits = [](){
+                    if constexpr (T_Color::template has_channel<graphics::color::I>)
+                    {
+                        return T_Color::template channel<graphics::color::I>.size;
+                    }
+                    else
+                    {
+                        return T_Color::template channel<graphics::color::L>.size;
+                    }
+                }();
                 constexpr auto num_colors = utils::bits<num_bits> + 1;
                 sdl_palette = SDL_CreatePalette(num_colors);
                 for (std::size_t i = 0; i < num_colors; ++i)
@@ -126,7 +205,193 @@ namespace picon::drivers
                 {
                     SDL_SetSurfacePalette(frame_buffer_surfaces[i], sdl_palette);
                 }
+            }
+
+            if (use_render_thread)
+            {
+                // textures can only be locked on the main thread, the worker draws into the cpu buffers.
+                use_locked_texture = false;
+                mailbox.store(front_buffer_idx);
+                present_buffer_idx = (back_buffer_idx + 1) % num_frame_buffers;
+            }
+
+            initRenderer();
+            stats_logged_at_us = time::getEpochTimeUs64();
+        }
+
+        void deinit()
+        {
+            deinitRenderer();
+
+            for (std::size_t i = 0; i < frame_buffers.size(); ++i)
+            {
+                SDL_DestroySurface(frame_buffer_surfaces[i]);
+            }
+
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+        }
+
+        /// present indexed frame buffers through p_palette, from the next swapped frame on.
+        /// only the SDL palette is touched, so palette swaps and color cycling cost O(palette).
+        /// called from the thread that draws and swaps, the main thread applies it with the frame.
+        template <graphics::color::ColorType T_PaletteFormat, std::size_t t_size>
+        requires(T_Color::template has_channel<graphics::color::I>)
+        void setPalette(const graphics::Palette<T_PaletteFormat, t_size>& p_palette)
+        {
+            staged_palette.num_colors = std::min<int>({static_cast<int>(t_size), sdl_palette->ncolors, static_cast<int>(staged_palette.colors.size())});
+            for (int i = 0; i < staged_palette.num_colors; ++i)
+            {
+                const auto color = graphics::color::convert<graphics::color::R8G8B8A8>(p_palette.colors[i]);
+                staged_palette.colors[i] = SDL_Color{
+                    static_cast<Uint8>(color.template get<graphics::color::R>()),
+                    static_cast<Uint8>(color.template get<graphics::color::G>()),
+                    static_cast<Uint8>(color.template get<graphics::color::B>()),
+                    static_cast<Uint8>(color.template get<graphics::color::A>()),
+                };
+            }
+            ++staged_palette.version;
+        }
+
+        const PresentStats& getPresentStats() const
+        {
+            return present_stats;
+        }
+
+        void resetPresentStats()
+        {
+            present_stats = {};
+        }
+
+        /// with use_render_thread, main thread side: pumps events for pollEvent and presents
+        /// the latest finished frame, blocking on vsync.
+        /// returns false without a new frame, after a short sleep.
+        bool presentLatest()
+        {
+            SDL_PumpEvents();
+
+            if ((mailbox.load(std::memory_order_acquire) & fresh_frame_bit) == 0)
+            {
+                SDL_Delay(1);
+                return false;
+            }
+
+            const auto fresh = mailbox.exchange(present_buffer_idx, std::memory_order_acq_rel);
+            if (on_transfer_done != nullptr)
+            {
+                on_transfer_done(on_transfer_done_context);
+            }
+            present_buffer_idx = fresh & ~fresh_frame_bit;
+            present(present_buffer_idx);
+            return true;
+        }
+
+        /// next pending event.
+        /// with use_render_thread this runs on the worker, which may only take
+        /// events from the queue the main thread pumps in presentLatest.
+        bool pollEvent(SDL_Event* r_event) const
+        {
+            if (use_render_thread)
+            {
+                return SDL_PeepEvents(r_event, 1, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST) > 0;
+            }
+            return SDL_PollEvent(r_event);
+        }
+
+        /// with use_locked_texture the presented frame lives only in its texture,
+        /// this returns the stale cpu frame buffer.
+        FrameBuffer& getFrontBuffer()
+        {
+            return frame_buffers[front_buffer_idx];
+        }
+
+        /// with use_locked_texture the returned view points into the locked texture,
+        /// whose previous contents are undefined, so the whole frame must be redrawn.
+        FrameBuffer& getBackBuffer()
+        {
+            if (use_locked_texture && !back_buffer_locked)
+            {
+                lockBackBuffer();
+            }
+            #if defined(PICON_GRAPHICS_INSTRUMENT)
+            overdraw.track(frame_buffers[back_buffer_idx]);
+            #endif
+            return frame_buffers[back_buffer_idx];
+        }
+        
+        /// whether the last swapped frame has been taken for presentation.
+        /// always true without use_render_thread, since swapBuffers presents synchronously.
+        bool isTransferDone() const
+        {
+            return !use_render_thread || (mailbox.load(std::memory_order_acquire) & fresh_frame_bit) == 0;
+        }
+
+        /// present the back buffer, or with use_render_thread hand it to the main
+        /// thread and continue with the oldest free buffer without waiting.
+        void swapBuffers()
+        {
+            swapped_at_us[back_buffer_idx] = time::getEpochTimeUs64();
+            if (frame_palettes[back_buffer_idx].version != staged_palette.version)
+            {
+                frame_palettes[back_buffer_idx] = staged_palette;
+            }
+
+            if (capture != nullptr)
+            {
+                capture->push(frame_buffers[back_buffer_idx]);
+            }
+
+            #if defined(PICON_GRAPHICS_INSTRUMENT)
+            if (show_overdraw)
+            {
+                overdraw.render(frame_buffers[back_buffer_idx]);
+            }
+            overdraw.clear();
+            #endif
+
+            if (use_render_thread)
+            {
+                const auto previous = mailbox.exchange(back_buffer_idx | fresh_frame_bit, std::memory_order_acq_rel);
+                if (previous & fresh_frame_bit)
+                {
+                    dropped_frames.fetch_add(1, std::memory_order_relaxed);
+                }
+                front_buffer_idx = back_buffer_idx;
+                back_buffer_idx = previous & ~fresh_frame_bit;
+                return;
+            }
+
+            present(back_buffer_idx);
+            front_buffer_idx = back_buffer_idx;
+            back_buffer_idx = (back_buffer_idx + 1) % frame_buffers.size();
+        }
 
+    private:
+        void initRenderer()
+        {
+            // try vulkan
+            renderer = SDL_CreateRenderer(window, "vulkan");
+            // fallback to default
+            if (renderer == nullptr)
+            {
+                renderer = SDL_CreateRenderer(window, nullptr);
+            }
+            // fail
+            if (renderer == nullptr)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not create renderer: %s\n", SDL_GetError());
+                abort();
+            }
+
+            SDL_SetRenderVSync(renderer, 1);
+
+            if (std::string{SDL_GetRendererName(renderer)} == "software")
+            {
+                use_frame_buffer_textures = false;
+            }
+
+            for (std::size_t i = 0; i < frame_buffers.size(); ++i)
+            {
                 if (use_frame_buffer_textures)
                 {
                     frame_buffer_textures[i] =
@@ -147,50 +412,44 @@ namespace picon::drivers
                 }
             }
 
+            if (!use_frame_buffer_textures)
+            {
+                use_locked_texture = false;
+            }
+
+            SDL_Log("Frame buffer path: %s%s",
+                use_locked_texture ? "locked texture" : use_frame_buffer_textures ? "texture copy" : "surface",
+                use_render_thread ? ", render thread" : "");
         }
 
-        void deinit()
+        void deinitRenderer()
         {
             for (std::size_t i = 0; i < frame_buffers.size(); ++i)
             {
-                if (!use_frame_buffer_textures)
+                if (use_frame_buffer_textures)
                 {
                     SDL_DestroyTexture(frame_buffer_textures[i]);
                 }
-                SDL_DestroySurface(frame_buffer_surfaces[i]);
             }
 
             SDL_DestroyRenderer(renderer);
-            SDL_DestroyWindow(window);
-            SDL_Quit();
         }
 
-        FrameBuffer& getFrontBuffer()
+        /// letterboxed destination of the frame buffer in a p_width x p_height output.
+        SDL_Rect getDstRect(int p_width, int p_height) const
         {
-            return frame_buffers[front_buffer_idx];
-        }
-
-        FrameBuffer& getBackBuffer()
-        {
-            return frame_buffers[(front_buffer_idx + 1) % frame_buffers.size()];
-        }
-        
-        void swapBuffers()
-        {
-            const auto window_surface = SDL_GetWindowSurface(window);
-
-            const auto window_aspect = static_cast<std::float_t>(window_surface->h) / window_surface->w;
+            const auto window_aspect = static_cast<std::float_t>(p_height) / p_width;
             const auto buffer_aspect = static_cast<std::float_t>(t_height) / t_width;
-            SDL_Rect dst_rect{ 0, 0, window_surface->w, window_surface->h };
+            SDL_Rect dst_rect{ 0, 0, p_width, p_height };
 
             std::size_t scale = 0;
             if (window_aspect > buffer_aspect)
             {
-                scale = window_surface->w / t_width;
+                scale = p_width / t_width;
             }
             else
             {
-                scale = window_surface->h / t_height;
+                scale = p_height / t_height;
             }
 
             // integer scaling
@@ -198,8 +457,8 @@ namespace picon::drivers
             {
                 const auto target_height = t_height * scale;
                 const auto target_width = t_width * scale;
-                const auto diff_height = window_surface->h - target_height;
-                const auto diff_width = window_surface->w - target_width;
+                const auto diff_height = p_height - target_height;
+                const auto diff_width = p_width - target_width;
                 dst_rect.y = diff_height / 2;
                 dst_rect.h = target_height;
                 dst_rect.x = diff_width / 2;
@@ -208,30 +467,49 @@ namespace picon::drivers
             // float scaling - bars above/below
             else if (window_aspect > buffer_aspect)
             {
-                const auto target_height = window_surface->w * buffer_aspect;
-                const auto diff_height = window_surface->h - target_height;
+                const auto target_height = p_width * buffer_aspect;
+                const auto diff_height = p_height - target_height;
                 dst_rect.y = diff_height / 2;
                 dst_rect.h = target_height;
             }
             // float scaling - bars left/right
             else if (window_aspect < buffer_aspect)
             {
-                const auto target_width = window_surface->h * (1.0f/buffer_aspect);
-                const auto diff_width = window_surface->w - target_width;
+                const auto target_width = p_height * (1.0f/buffer_aspect);
+                const auto diff_width = p_width - target_width;
                 dst_rect.x = diff_width / 2;
                 dst_rect.w = target_width;
             }
 
+            return dst_rect;
+        }
+
+        /// upload frame buffer p_idx and present it, blocks on vsync. main thread only.
+        void present(std::size_t p_idx)
+        {
+            const auto start = time::getEpochTimeUs64();
+
+            if (frame_palettes[p_idx].version != applied_palette_version)
+            {
+                SDL_SetPaletteColors(sdl_palette, frame_palettes[p_idx].colors.data(), 0, frame_palettes[p_idx].num_colors);
+                applied_palette_version = frame_palettes[p_idx].version;
+            }
+
             if (!use_frame_buffer_textures)
             {
-                const auto back_buffer_surface = frame_buffer_surfaces[(front_buffer_idx + 1) % frame_buffer_surfaces.size()];
-                
+                const auto window_surface = SDL_GetWindowSurface(window);
+                const auto dst_rect = getDstRect(window_surface->w, window_surface->h);
+
                 SDL_ClearSurface(window_surface, 0, 0, 0, 1);
-                SDL_StretchSurface(back_buffer_surface, nullptr, window_surface, &dst_rect, SDL_SCALEMODE_NEAREST);
+                SDL_StretchSurface(frame_buffer_surfaces[p_idx], nullptr, window_surface, &dst_rect, SDL_SCALEMODE_NEAREST);
                 SDL_UpdateWindowSurface(window);
             }
             else
             {
+                int output_width{};
+                int output_height{};
+                SDL_GetRenderOutputSize(renderer, &output_width, &output_height);
+                const auto dst_rect = getDstRect(output_width, output_height);
 
                 const SDL_FRect dst_frect = {
                     static_cast<std::float_t>(dst_rect.x),
@@ -240,18 +518,33 @@ namespace picon::drivers
                     static_cast<std::float_t>(dst_rect.h),
                 };
 
-                const auto back_buffer_texture = frame_buffer_textures[(front_buffer_idx + 1) % frame_buffer_surfaces.size()];
-                typename T_Color::Value* pixels{};
-                int pitch;
-                SDL_LockTexture(back_buffer_texture, nullptr, reinterpret_cast<void**>(&pixels), &pitch);
-                assert(pitch == t_width * sizeof(typename T_Color::Value));
-                std::copy(getBackBuffer().begin(), getBackBuffer().end(), pixels);
-                SDL_UnlockTexture(back_buffer_texture);
+                const auto texture = frame_buffer_textures[p_idx];
+                if (back_buffer_locked)
+                {
+                    // the view dies with the lock.
+                    SDL_UnlockTexture(texture);
+                    frame_buffers[p_idx] = frame_buffer_data[p_idx];
+                    back_buffer_locked = false;
+                }
+                else if (!use_locked_texture)
+                {
+                    T_Color* pixels{};
+                    int pitch{};
+                    SDL_LockTexture(texture, nullptr, reinterpret_cast<void**>(&pixels), &pitch);
+                    for (std::size_t y = 0; y < t_height; ++y)
+                    {
+                        std::copy(
+                            frame_buffers[p_idx].rowBegin(y),
+                            frame_buffers[p_idx].rowBegin(y) + t_width,
+                            reinterpret_cast<T_Color*>(reinterpret_cast<std::uint8_t*>(pixels) + y * pitch));
+                    }
+                    SDL_UnlockTexture(texture);
+                }
 
                 SDL_RenderClear(renderer);
 
                 [[maybe_unused]] const auto sdl_render_success =
-                    SDL_RenderTexture(renderer, back_buffer_texture, nullptr, &dst_frect);
+                    SDL_RenderTexture(renderer, texture, nullptr, &dst_frect);
                     
                 #if !defined(NDEBUG)
                     if (!sdl_render_success)
@@ -263,8 +556,59 @@ namespace picon::drivers
 
                 SDL_RenderPresent(renderer);
             }
-            
-            front_buffer_idx = (front_buffer_idx + 1) % frame_buffers.size();
+
+            const auto end = time::getEpochTimeUs64();
+            measure(end - start, start - std::min(start, swapped_at_us[p_idx]), end);
+        }
+
+        void measure(std::uint64_t p_present_us, std::uint64_t p_latency_us, std::uint64_t p_now_us)
+        {
+            auto& stats = present_stats;
+            stats.frames += 1;
+            stats.dropped = dropped_frames.load(std::memory_order_relaxed);
+            stats.present_us_sum += p_present_us;
+            stats.present_us_max = std::max(stats.present_us_max, p_present_us);
+            stats.latency_us_sum += p_latency_us;
+            stats.latency_us_max = std::max(stats.latency_us_max, p_latency_us);
+
+            if (stats_log_interval_us == 0 || p_now_us - stats_logged_at_us < stats_log_interval_us) { return; }
+
+            SDL_Log("present: %llu frames, %llu dropped, present %llu us mean %llu us max, latency %llu us mean %llu us max",
+                static_cast<unsigned long long>(stats.frames),
+                static_cast<unsigned long long>(stats.dropped),
+                static_cast<unsigned long long>(stats.getMeanPresentUs()),
+                static_cast<unsigned long long>(stats.present_us_max),
+                static_cast<unsigned long long>(stats.getMeanLatencyUs()),
+                static_cast<unsigned long long>(stats.latency_us_max));
+            stats_logged_at_us = p_now_us;
+            dropped_frames.store(0, std::memory_order_relaxed);
+            stats = {};
+        }
+
+        /// lock the back texture and point the back frame buffer at its pixels.
+        /// a pitch with row padding can't be expressed by Image, so that
+        /// permanently falls back to the cpu frame buffers.
+        void lockBackBuffer()
+        {
+            void* pixels{};
+            int pitch{};
+            if (!SDL_LockTexture(frame_buffer_textures[back_buffer_idx], nullptr, &pixels, &pitch))
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not lock texture: %s\n", SDL_GetError());
+                use_locked_texture = false;
+                return;
+            }
+
+            if (static_cast<std::size_t>(pitch) != t_width * sizeof(T_Color))
+            {
+                SDL_Log("Texture pitch %d doesn't match frame buffer width, falling back to texture copy", pitch);
+                SDL_UnlockTexture(frame_buffer_textures[back_buffer_idx]);
+                use_locked_texture = false;
+                return;
+            }
+
+            frame_buffers[back_buffer_idx] = FrameBuffer{t_width, t_height, static_cast<T_Color*>(pixels)};
+            back_buffer_locked = true;
         }
     };
 
@@ -1,22 +1,18 @@
 #pragma once
 
-#if defined(PICON_PLATFORM_PICO)
+#include "graphics/color.hpp"
 #include "graphics/image.hpp"
 
-#include <hardware/dma.h>
-#include <hardware/gpio.h>
-#include <hardware/pio.h>
-#include <hardware/pio_instructions.h>
-#include <hardware/spi.h>
-#include <hardware/structs/io_bank0.h>
-#include <pico.h>
-#include <pico/platform/common.h>
-#include <pico/time.h>
-
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
-#include <cstdio>
+#include <limits>
+#include <span>
 
 namespace picon::drivers
 {
@@ -50,291 +46,680 @@ namespace picon::drivers
         return static_cast<std::uint8_t>(cmd);
     }
 
-    template <
-        std::size_t t_width,
-        std::size_t t_height,
-        std::uint8_t t_sck,
-        std::uint8_t t_mosi,
-        std::uint8_t t_dc,
-        std::uint8_t t_cs,
-        std::uint8_t t_rst>
-    struct SH1122Driver
+
+    /// pack GS4 pixels two per byte as the SH1122 takes them on the wire,
+    /// left pixel in the high nibble.
+    constexpr void packGS4(std::span<const graphics::color::GS4> p_src, std::span<std::uint8_t> p_dst)
     {
-        static constexpr auto sck = t_sck;
-        static constexpr auto mosi = t_mosi;
-        static constexpr auto dc = t_dc;
-        static constexpr auto cs = t_cs;
-        static constexpr auto rst = t_rst;
+        for (std::size_t i = 0; i < p_dst.size(); ++i)
+        {
+            p_dst[i] = static_cast<std::uint8_t>(
+                p_src[i * 2].get<graphics::color::L>() << 4 |
+                p_src[i * 2 + 1].get<graphics::color::L>());
+        }
+    }
 
-        static constexpr auto width = t_width;
-        static constexpr auto height = t_height;
+    static_assert([](){
+        using graphics::color::GS4;
+        const std::array<GS4, 6> src{GS4{0x1}, GS4{0x2}, GS4{0xA}, GS4{0xF}, GS4{0x0}, GS4{0x7}};
+        std::array<std::uint8_t, 3> dst{};
+        packGS4(src, dst);
+        return dst == std::array<std::uint8_t, 3>{0x12, 0xAF, 0x07};
+    }());
 
-        using FrameBufferData = graphics::ImageData<graphics::color::GS4, width, height>;
-        using FrameBuffer = graphics::Image<graphics::color::GS4>;
 
-        std::array<FrameBufferData, 2> frame_buffer_data{};
-        std::array<FrameBuffer, 2> frame_buffers{
-            frame_buffer_data[0],
-            frame_buffer_data[1],
-        };
-        std::size_t front_buffer_idx{};
+    /// how the bytes of a segment are clocked out, selects the dc line.
+    enum class SH1122SegmentKind : std::uint8_t
+    {
+        command,
+        data,
+    };
 
-        std::uint8_t dma_channel{};
-        dma_channel_config dma_config{};
+    /// contiguous run of bytes for the display bus.
+    /// data must stay valid until on_done is called.
+    struct SH1122Segment
+    {
+        SH1122SegmentKind kind{};
+        const std::uint8_t* data{};
+        std::size_t size{};
+        /// called once the segment has left the bus, from interrupt context on hardware.
+        void (*on_done)(void* p_context){};
+        void* context{};
+    };
 
-        PIO pio{};
-        uint pio_sm{};
-        uint pio_offset{};
+    /// single producer, single consumer ring of pending segments.
+    /// the render path pushes, the transport completion pops.
+    /// @tparam t_capacity
+    template <std::size_t t_capacity>
+    requires(std::has_single_bit(t_capacity))
+    struct SH1122SegmentQueue
+    {
+        std::array<SH1122Segment, t_capacity> segments{};
+        std::atomic<std::size_t> head{};
+        std::atomic<std::size_t> tail{};
 
-        uint pio_command_start{};
-        uint pio_command_end{};
-        uint pio_data_start{};
-        uint pio_data_end{};
+        std::size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+        bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+        bool full() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire) == t_capacity; }
 
-        // SH1122Driver(PIO p_pio): pio{p_pio} {}
+        bool push(const SH1122Segment& p_segment)
+        {
+            if (full()) { return false; }
+            const auto tail_idx = tail.load(std::memory_order_relaxed);
+            segments[tail_idx % t_capacity] = p_segment;
+            tail.store(tail_idx + 1, std::memory_order_release);
+            return true;
+        }
 
-        void init()
+        const SH1122Segment& front() const
         {
-            initSpiPio(pio);
-            initDma();
-            initGpio();
-            initDisplay();
+            return segments[head.load(std::memory_order_relaxed) % t_capacity];
         }
 
-        void deinit()
+        void pop()
         {
-            // TODO: add proper deinit stuff
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
         }
+    };
+
+
+    /// moves segments to the display in order, without blocking the caller.
+    /// submit returns false when the queue is full, poll advances completions
+    /// that aren't interrupt driven.
+    template <typename T_Transport>
+    concept SH1122Transport = requires(T_Transport& r_transport, const SH1122Segment& p_segment)
+    {
+        r_transport.init();
+        { r_transport.submit(p_segment) } -> std::same_as<bool>;
+        r_transport.poll();
+        { r_transport.isIdle() } -> std::same_as<bool>;
+        { r_transport.getFreeSlots() } -> std::convertible_to<std::size_t>;
+    };
+
+
+    /// rectangle of display memory, in rows and columns.
+    /// a column is one byte, two pixels wide.
+    struct SH1122Window
+    {
+        std::uint16_t row{};
+        std::uint16_t num_rows{};
+        std::uint16_t column{};
+        std::uint16_t num_columns{};
 
-        FrameBuffer& getFrontBuffer()
+        constexpr bool operator==(const SH1122Window&) const = default;
+    };
+
+    /// bus cost of a window, in byte times.
+    /// every row of a narrow window needs its own address and data segment,
+    /// full width windows are sent as one run because the address wraps to the next row.
+    struct SH1122CostModel
+    {
+        /// bytes of the row and column address commands.
+        std::size_t header_bytes{4};
+        /// fixed cost of a segment: dma setup and waiting for the bus to drain before dc changes.
+        std::size_t segment_bytes{16};
+
+        constexpr bool isFullWidth(const SH1122Window& p_window, std::size_t p_columns) const
         {
-            return frame_buffers[front_buffer_idx];
+            return p_window.num_columns == p_columns;
         }
 
-        FrameBuffer& getBackBuffer()
+        constexpr std::size_t getSegments(const SH1122Window& p_window, std::size_t p_columns) const
         {
-            return frame_buffers[(front_buffer_idx + 1) % frame_buffers.size()];
+            return isFullWidth(p_window, p_columns) ? 2 : 2 * p_window.num_rows;
         }
 
-        void swapBuffers()
+        constexpr std::size_t getCost(const SH1122Window& p_window, std::size_t p_columns) const
         {
-            if (dma_channel_is_busy(dma_channel))
-            {
-                dma_channel_wait_for_finish_blocking(dma_channel);
-            }
+            const auto runs = isFullWidth(p_window, p_columns) ? 1 : p_window.num_rows;
+            return runs * (2 * segment_bytes + header_bytes) + p_window.num_rows * p_window.num_columns;
+        }
+    };
 
-            deselectDevice();
-            selectDevice();
-            
-            // setCmdMode();
-            // writeCmd(+SH1122Commands::set_row_addr, 0x00);
-            // writeCmd(+SH1122Commands::set_lower_column_addr, +SH1122Commands::set_higher_column_addr);
-            // setDataMode();
+    template <std::size_t t_capacity>
+    struct SH1122WindowList
+    {
+        std::array<SH1122Window, t_capacity> windows{};
+        std::size_t size{};
 
-            const auto &back_buffer = getBackBuffer();
-            front_buffer_idx = (front_buffer_idx + 1) % frame_buffers.size();
+        constexpr std::span<const SH1122Window> get() const
+        {
+            return {windows.data(), size};
+        }
+    };
 
-            pioSpiWrite(std::bit_cast<const std::uint8_t*>(back_buffer.data()), back_buffer.size());
+    namespace internal
+    {
 
+        constexpr SH1122Window unite(const SH1122Window& p_a, const SH1122Window& p_b)
+        {
+            const auto row = std::min(p_a.row, p_b.row);
+            const auto column = std::min(p_a.column, p_b.column);
+            return {
+                .row = row,
+                .num_rows = static_cast<std::uint16_t>(std::max(p_a.row + p_a.num_rows, p_b.row + p_b.num_rows) - row),
+                .column = column,
+                .num_columns = static_cast<std::uint16_t>(std::max(p_a.column + p_a.num_columns, p_b.column + p_b.num_columns) - column),
+            };
         }
 
-    private:
-        void selectDevice()
+        constexpr SH1122Window widen(const SH1122Window& p_window, std::size_t p_columns)
         {
-            gpio_put(cs, 0);
+            return {p_window.row, p_window.num_rows, 0, static_cast<std::uint16_t>(p_columns)};
         }
 
-        void deselectDevice()
+        /// the cheaper of p_window and its full width version.
+        constexpr SH1122Window cheapest(const SH1122Window& p_window, std::size_t p_columns, const SH1122CostModel& p_cost)
         {
-            gpio_put(cs, 1);
+            const auto wide = widen(p_window, p_columns);
+            return p_cost.getCost(wide, p_columns) < p_cost.getCost(p_window, p_columns) ? wide : p_window;
         }
 
-        void setCmdMode()
+        struct MergeCandidate
         {
-            pio_sm_set_enabled(pio, pio_sm, false);
-            pio_sm_set_wrap(pio, pio_sm, pio_offset + pio_command_start, pio_offset + pio_command_end);
-            pio->sm[pio_sm].instr = pio_offset + pio_command_start;
-            pio_sm_set_enabled(pio, pio_sm, true);
-            gpio_put(dc, 0);
+            std::size_t a{};
+            std::size_t b{};
+            std::ptrdiff_t saving{};
+        };
+
+        /// pair whose union saves the most, saving is negative if merging costs extra.
+        template <std::size_t t_capacity>
+        constexpr MergeCandidate findMerge(const SH1122WindowList<t_capacity>& p_list, std::size_t p_columns, const SH1122CostModel& p_cost)
+        {
+            MergeCandidate best{.saving = std::numeric_limits<std::ptrdiff_t>::min()};
+            for (std::size_t a = 0; a < p_list.size; ++a)
+            {
+                for (std::size_t b = a + 1; b < p_list.size; ++b)
+                {
+                    const auto& window_a = p_list.windows[a];
+                    const auto& window_b = p_list.windows[b];
+                    const auto united = cheapest(unite(window_a, window_b), p_columns, p_cost);
+                    const auto saving =
+                        static_cast<std::ptrdiff_t>(p_cost.getCost(window_a, p_columns) + p_cost.getCost(window_b, p_columns)) -
+                        static_cast<std::ptrdiff_t>(p_cost.getCost(united, p_columns));
+                    if (saving > best.saving) { best = {a, b, saving}; }
+                }
+            }
+            return best;
         }
 
-        void setDataMode()
+        template <std::size_t t_capacity>
+        constexpr void merge(SH1122WindowList<t_capacity>& r_list, const MergeCandidate& p_merge, std::size_t p_columns, const SH1122CostModel& p_cost)
         {
-            pio_sm_set_enabled(pio, pio_sm, false);
-            pio_sm_set_wrap(pio, pio_sm, pio_offset + pio_data_start, pio_offset + pio_data_end);
-            pio->sm[pio_sm].instr = pio_offset + pio_data_start;
-            pio_sm_set_enabled(pio, pio_sm, true);
-            gpio_put(dc, 1);
+            r_list.windows[p_merge.a] = cheapest(unite(r_list.windows[p_merge.a], r_list.windows[p_merge.b]), p_columns, p_cost);
+            r_list.windows[p_merge.b] = r_list.windows[--r_list.size];
         }
 
-        void writeCmd(std::uint8_t p_cmd)
+    } // namespace internal
+
+    /// merge p_dirty into the windows that are cheapest to send under p_cost,
+    /// using at most p_max_segments segments. windows must lie inside the frame.
+    /// a budget below 2 is taken as 2, the one address and data pair of a full frame.
+    /// returned windows are sorted by row.
+    template <std::size_t t_capacity>
+    constexpr SH1122WindowList<t_capacity> planWindows(
+        std::span<const SH1122Window> p_dirty,
+        std::size_t p_columns,
+        const SH1122CostModel& p_cost,
+        std::size_t p_max_segments)
+    {
+        const auto max_segments = std::max<std::size_t>(p_max_segments, 2);
+
+        SH1122WindowList<t_capacity> list{};
+        for (const auto& window : p_dirty)
         {
-            pioSpiWriteBlocking(&p_cmd, 1);
+            if (window.num_rows == 0 || window.num_columns == 0) { continue; }
+            if (list.size == t_capacity)
+            {
+                internal::merge(list, internal::findMerge(list, p_columns, p_cost), p_columns, p_cost);
+            }
+            list.windows[list.size++] = internal::cheapest(window, p_columns, p_cost);
         }
 
-        void writeCmd(std::uint8_t p_cmd, std::uint8_t p_value)
+        while (list.size > 1)
         {
-            writeCmd(p_cmd);
-            writeCmd(p_value);
+            const auto candidate = internal::findMerge(list, p_columns, p_cost);
+            if (candidate.saving < 0) { break; }
+            internal::merge(list, candidate, p_columns, p_cost);
         }
 
-        void initDisplay()
+        // over budget: send the narrow window with the most rows as full rows,
+        // once all are full width merge the cheapest pair.
+        const auto getSegments = [&](){
+            std::size_t segments{};
+            for (const auto& window : list.get()) { segments += p_cost.getSegments(window, p_columns); }
+            return segments;
+        };
+        while (getSegments() > max_segments)
         {
-            selectDevice();
-            setCmdMode();
-            writeCmd(+SH1122Commands::display_off);
-            // writeCmd(+SH1122Commands::set_display_clock_div, 0xF0);
-            writeCmd(+SH1122Commands::set_display_clock_div, 0x50);
-            // writeCmd(+SH1122Commands::set_display_offset, 0x00);
-            writeCmd(+SH1122Commands::set_start_line, 0x00);
-            writeCmd(+SH1122Commands::charge_pump, 0x8F);
-            writeCmd(+SH1122Commands::segment_remap | 0x00);
-            writeCmd(+SH1122Commands::com_scan_dir);
-            writeCmd(+SH1122Commands::set_contrast, 0x10);
-            writeCmd(+SH1122Commands::set_contrast, 0x70);
-            writeCmd(+SH1122Commands::set_multiplex, 0x3F);
-            // writeCmd(+SH1122Commands::set_precharge, 0x81);
-            writeCmd(+SH1122Commands::set_precharge, 0x92);
-
-            writeCmd(+SH1122Commands::set_vcom_deselect, 0x00);
-            writeCmd(+SH1122Commands::set_vsegm, 0x00);
-            // writeCmd(+SH1122Commands::set_vcom_deselect, 0x35);
-            // writeCmd(+SH1122Commands::set_vsegm, 0x35);
-            writeCmd(+SH1122Commands::set_discharge_vsl | 0x06);
-            // writeCmd(+SH1122Commands::set_discharge_vsl | 0x00);
-            
-            writeCmd(+SH1122Commands::display_all_on_resume);
-            writeCmd(+SH1122Commands::normal_display);
-            writeCmd(+SH1122Commands::display_on);
-
-            setDataMode();
-
-            deselectDevice();
+            const auto narrowest = std::max_element(list.windows.begin(), list.windows.begin() + list.size,
+                [&](const auto& p_a, const auto& p_b){
+                    return p_cost.getSegments(p_a, p_columns) < p_cost.getSegments(p_b, p_columns);
+                });
+            if (p_cost.getSegments(*narrowest, p_columns) > 2)
+            {
+                *narrowest = internal::widen(*narrowest, p_columns);
+            }
+            else
+            {
+                internal::merge(list, internal::findMerge(list, p_columns, p_cost), p_columns, p_cost);
+            }
         }
 
-        void initGpio()
+        std::sort(list.windows.begin(), list.windows.begin() + list.size,
+            [](const auto& p_a, const auto& p_b){ return p_a.row < p_b.row; });
+        return list;
+    }
+
+    /// address commands for p_row, p_column.
+    constexpr std::array<std::uint8_t, 4> encodeAddress(std::size_t p_row, std::size_t p_column)
+    {
+        return {
+            +SH1122Commands::set_row_addr,
+            static_cast<std::uint8_t>(p_row),
+            static_cast<std::uint8_t>(+SH1122Commands::set_lower_column_addr | (p_column & 0x0F)),
+            static_cast<std::uint8_t>(+SH1122Commands::set_higher_column_addr | (p_column >> 4)),
+        };
+    }
+
+    /// command and data segments for one frame, the commands live here until sent.
+    /// @tparam t_max_segments
+    template <std::size_t t_max_segments>
+    requires(t_max_segments >= 2)
+    struct SH1122Plan
+    {
+        static constexpr auto max_segments = t_max_segments;
+
+        std::array<std::uint8_t, t_max_segments / 2 * 4> commands{};
+        std::array<SH1122Segment, t_max_segments> segments{};
+        std::size_t num_segments{};
+        std::size_t num_data_bytes{};
+
+        constexpr std::span<const SH1122Segment> get() const
         {
-            gpio_init(dc);
-            gpio_init(cs);
-            gpio_init(rst);
-            gpio_set_dir(dc, GPIO_OUT);
-            gpio_set_dir(cs, GPIO_OUT);
-            gpio_set_dir(rst, GPIO_OUT);
-            gpio_put(rst, 1);
+            return {segments.data(), num_segments};
         }
-        
-        void initDma()
+    };
+
+    /// address and data segments sending p_windows of p_frame, p_columns bytes per row.
+    /// full width windows go out as one run, narrow windows row by row.
+    template <std::size_t t_max_segments>
+    requires(t_max_segments >= 2)
+    constexpr void encodeWindows(
+        std::span<const SH1122Window> p_windows,
+        std::span<const std::uint8_t> p_frame,
+        std::size_t p_columns,
+        SH1122Plan<t_max_segments>& r_plan)
+    {
+        r_plan.num_segments = 0;
+        r_plan.num_data_bytes = 0;
+        std::size_t num_commands{};
+
+        const auto emit = [&](std::size_t p_row, std::size_t p_column, std::size_t p_size){
+            assert(r_plan.num_segments + 2 <= t_max_segments);
+            const auto address = encodeAddress(p_row, p_column);
+            std::copy(address.begin(), address.end(), r_plan.commands.begin() + num_commands);
+            r_plan.segments[r_plan.num_segments++] = {
+                .kind = SH1122SegmentKind::command,
+                .data = r_plan.commands.data() + num_commands,
+                .size = address.size(),
+            };
+            num_commands += address.size();
+
+            r_plan.segments[r_plan.num_segments++] = {
+                .kind = SH1122SegmentKind::data,
+                .data = p_frame.data() + p_row * p_columns + p_column,
+                .size = p_size,
+            };
+            r_plan.num_data_bytes += p_size;
+        };
+
+        for (const auto& window : p_windows)
         {
-            dma_channel = dma_claim_unused_channel(true);
-            dma_config = dma_channel_get_default_config(dma_channel);
-            channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_8);
-            channel_config_set_dreq(&dma_config, pio_get_dreq(pio, pio_sm, true));
+            if (window.num_columns == p_columns)
+            {
+                emit(window.row, 0, window.num_rows * p_columns);
+                continue;
+            }
+
+            for (std::size_t row = window.row; row < window.row + window.num_rows; ++row)
+            {
+                emit(row, window.column, window.num_columns);
+            }
         }
+    }
+
+    static_assert([](){
+        using graphics::color::GS4;
+        constexpr std::size_t columns = 4;
+        constexpr std::size_t rows = 2;
+
+        std::array<GS4, columns * 2 * rows> pixels{};
+        for (std::size_t i = 0; i < pixels.size(); ++i) { pixels[i] = GS4{static_cast<std::uint8_t>(i & 0xF)}; }
+        std::array<std::uint8_t, columns * rows> packed{};
+        packGS4(pixels, packed);
+
+        // a full frame is one address at 0, 0 followed by the packed frame as one data run.
+        const std::array<SH1122Window, 1> full{{{0, rows, 0, columns}}};
+        SH1122Plan<2> plan{};
+        encodeWindows(full, packed, columns, plan);
+        if (plan.num_segments != 2 || plan.num_data_bytes != packed.size()) { return false; }
+
+        const auto& address = plan.segments[0];
+        const auto& data = plan.segments[1];
+        const auto expected_address = encodeAddress(0, 0);
+        return
+            address.kind == SH1122SegmentKind::command &&
+            std::equal(address.data, address.data + address.size, expected_address.begin(), expected_address.end()) &&
+            data.kind == SH1122SegmentKind::data &&
+            std::equal(data.data, data.data + data.size, packed.begin(), packed.end());
+    }());
+
+
+    /// model of the SH1122 display memory, to check command streams on the host.
+    /// data writes advance the column and continue at the start of the next row
+    /// after the last column, which full frame runs rely on.
+    template <std::size_t t_columns = 128, std::size_t t_rows = 64>
+    struct SH1122Gram
+    {
+        std::array<std::uint8_t, t_columns * t_rows> memory{};
+        std::size_t row{};
+        std::size_t column{};
 
-        void initSpiPio(PIO p_pio)
+        /// command waiting for its operand byte.
+        std::uint8_t pending_command{};
+        bool has_pending_command{};
+
+        constexpr void apply(const SH1122Segment& p_segment)
         {
-            pio = p_pio;
-            
-            static const std::array<std::uint16_t, 8> instructions{
-                // command program
-                static_cast<std::uint16_t>(
-                    pio_encode_set(pio_src_dest::pio_x, 7) |
-                    pio_encode_sideset(1, 0)),
-                static_cast<std::uint16_t>(
-                    pio_encode_out(pio_src_dest::pio_pins, 1) |
-                    pio_encode_sideset(1, 0)),
-                static_cast<std::uint16_t>(
-                    pio_encode_jmp_x_dec(1) |
-                    pio_encode_sideset(1, 1)),
-                static_cast<std::uint16_t>(
-                    pio_encode_irq_set(false, 0) |
-                    pio_encode_sideset(1, 0)),
-                // data program
-                static_cast<std::uint16_t>(
-                    pio_encode_out(pio_src_dest::pio_null, 4) |
-                    pio_encode_sideset(1, 0)),
-                static_cast<std::uint16_t>(
-                    pio_encode_set(pio_src_dest::pio_x, 3) |
-                    pio_encode_sideset(1, 0)),
-                static_cast<std::uint16_t>(
-                    pio_encode_out(pio_src_dest::pio_pins, 1) |
-                    pio_encode_sideset(1, 0)),
-                static_cast<std::uint16_t>(
-                    pio_encode_jmp_x_dec(6) |
-                    pio_encode_sideset(1, 1)),
-            };
+            for (std::size_t i = 0; i < p_segment.size; ++i)
+            {
+                if (p_segment.kind == SH1122SegmentKind::command) { applyCommand(p_segment.data[i]); }
+                else { applyData(p_segment.data[i]); }
+            }
+        }
 
-            pio_command_start = 0;
-            pio_command_end = 3;
-            pio_data_start = 4;
-            pio_data_end = 7;
+        constexpr void applyCommand(std::uint8_t p_byte)
+        {
+            if (has_pending_command)
+            {
+                has_pending_command = false;
+                if (pending_command == +SH1122Commands::set_row_addr) { row = p_byte % t_rows; }
+                return;
+            }
 
-            // printf("out: 0x%x\n", instructions[0]);
-            // printf("in: 0x%x\n", instructions[1]);
+            switch (p_byte)
+            {
+            case +SH1122Commands::set_row_addr:
+            case +SH1122Commands::set_display_clock_div:
+            case +SH1122Commands::set_multiplex:
+            case +SH1122Commands::set_display_offset:
+            case +SH1122Commands::charge_pump:
+            case +SH1122Commands::set_contrast:
+            case +SH1122Commands::set_precharge:
+            case +SH1122Commands::set_vcom_deselect:
+            case +SH1122Commands::set_vsegm:
+                pending_command = p_byte;
+                has_pending_command = true;
+                return;
+            }
 
-            const pio_program program {
-                .instructions = instructions.data(),
-                .length = static_cast<std::uint8_t>(instructions.size()),
-                .origin = -1,
-                .pio_version = 0,
-            };
+            if ((p_byte & 0xF0) == +SH1122Commands::set_lower_column_addr)
+            {
+                column = (column & 0x70) | (p_byte & 0x0F);
+            }
+            else if ((p_byte & 0xF8) == +SH1122Commands::set_higher_column_addr)
+            {
+                column = (column & 0x0F) | (p_byte & 0x07) << 4;
+            }
+        }
+
+        constexpr void applyData(std::uint8_t p_byte)
+        {
+            memory[row * t_columns + column % t_columns] = p_byte;
+            if (++column >= t_columns)
+            {
+                column = 0;
+                row = (row + 1) % t_rows;
+            }
+        }
+    };
 
-            pio_sm = pio_claim_unused_sm(pio, true);
+    static_assert([](){
+        constexpr std::size_t columns = 8;
+        constexpr SH1122CostModel cost{.header_bytes = 4, .segment_bytes = 1};
+
+        // touching windows merge, distant ones stay apart.
+        const std::array<SH1122Window, 3> dirty{{{0, 2, 1, 2}, {0, 2, 3, 1}, {6, 1, 5, 1}}};
+        const auto planned = planWindows<4>(dirty, columns, cost, 16);
+        if (planned.size != 2) { return false; }
+        if (planned.windows[0] != SH1122Window{0, 2, 1, 3}) { return false; }
+        if (planned.windows[1] != SH1122Window{6, 1, 5, 1}) { return false; }
+
+        // a segment budget of 2 forces a single full width run.
+        const auto budget = planWindows<4>(dirty, columns, cost, 2);
+        if (budget.size != 1 || budget.windows[0] != SH1122Window{0, 7, 0, columns}) { return false; }
+
+        // no budget at all still plans that run instead of never converging.
+        const auto none = planWindows<4>(dirty, columns, cost, 0);
+        return none.size == 1 && none.windows[0] == budget.windows[0];
+    }());
+
+    static_assert([](){
+        constexpr std::size_t columns = 8;
+        constexpr std::size_t rows = 4;
+        constexpr SH1122CostModel cost{.header_bytes = 4, .segment_bytes = 1};
+
+        std::array<std::uint8_t, columns * rows> before{};
+        for (std::size_t i = 0; i < before.size(); ++i) { before[i] = static_cast<std::uint8_t>(i); }
+
+        const std::array<SH1122Window, 2> dirty{{{0, 2, 2, 3}, {3, 1, 0, columns}}};
+        auto after = before;
+        for (const auto& window : dirty)
+        {
+            for (std::size_t row = window.row; row < window.row + window.num_rows; ++row)
+            {
+                for (std::size_t column = window.column; column < window.column + window.num_columns; ++column)
+                {
+                    after[row * columns + column] = static_cast<std::uint8_t>(0xF0 | row << 2 | column);
+                }
+            }
+        }
+
+        const std::array<SH1122Window, 1> full{{{0, rows, 0, columns}}};
+        SH1122Plan<8> plan{};
 
-            pio_offset = pio_add_program(pio, &program);
-            auto config{pio_get_default_sm_config()};
+        SH1122Gram<columns, rows> full_path{};
+        full_path.column = 5;
+        encodeWindows(full, after, columns, plan);
+        for (const auto& segment : plan.get()) { full_path.apply(segment); }
 
-            sm_config_set_wrap(&config, pio_offset + pio_command_start, pio_offset + pio_command_end);
-            // sm_config_set_wrap(&config, pio_offset + pio_data_start, pio_offset + pio_data_end);
+        SH1122Gram<columns, rows> partial_path{};
+        encodeWindows(full, before, columns, plan);
+        for (const auto& segment : plan.get()) { partial_path.apply(segment); }
+        const auto planned = planWindows<4>(dirty, columns, cost, plan.max_segments);
+        encodeWindows(planned.get(), after, columns, plan);
+        for (const auto& segment : plan.get()) { partial_path.apply(segment); }
 
-            sm_config_set_sideset(&config, 1, false, false);
-            sm_config_set_out_shift(&config, false, true, 8);
-            sm_config_set_in_shift(&config, false, false, 8);
-            // sm_config_set_clkdiv_int_frac8(&config, 5, 0);
-            sm_config_set_clkdiv_int_frac8(&config, 4, 0);
-            // sm_config_set_clkdiv_int_frac8(&config, 3, 0);
-            // sm_config_set_clkdiv_int_frac8(&config, 2, 0);
+        return full_path.memory == after && partial_path.memory == after && plan.num_data_bytes < after.size();
+    }());
 
-            sm_config_set_out_pins(&config, mosi, 1);
-            sm_config_set_sideset_pins(&config, sck);
-            
-            pio_sm_set_pins_with_mask(pio, pio_sm, 0, (1u << sck) | (1u << mosi));
-            pio_sm_set_pindirs_with_mask(pio, pio_sm, -1, (1u << sck) | (1u << mosi));
-            pio_gpio_init(pio, mosi);
-            pio_gpio_init(pio, sck);
 
-            pio_sm_init(pio, pio_sm, pio_offset, &config);
+    /// SH1122 protocol: command sequences and frame submission over any SH1122Transport.
+    /// @tparam t_max_segments segments one frame may take, the transport queue must fit two frames.
+    template <
+        std::size_t t_width,
+        std::size_t t_height,
+        SH1122Transport T_Transport,
+        std::size_t t_max_segments = 16>
+    requires(t_max_segments >= 2)
+    struct SH1122Driver
+    {
+        static constexpr auto width = t_width;
+        static constexpr auto height = t_height;
+        /// bytes per packed row.
+        static constexpr auto columns = width / 2;
+
+        using FrameBufferData = graphics::ImageData<graphics::color::GS4, width, height>;
+        using FrameBuffer = graphics::Image<graphics::color::GS4>;
+
+        static_assert(width % 2 == 0, "packed rows need an even width");
+
+        static_assert(width == 256 && height <= 64, "frame rows must be whole display memory rows");
+
+        /// frame as sent on the wire, two pixels per byte.
+        using PackedFrame = std::array<std::uint8_t, width * height / 2>;
+        using Plan = SH1122Plan<t_max_segments>;
+
+        static constexpr std::array<std::uint8_t, 25> init_commands{
+            +SH1122Commands::display_off,
+            +SH1122Commands::set_display_clock_div, 0x50,
+            +SH1122Commands::set_start_line, 0x00,
+            +SH1122Commands::charge_pump, 0x8F,
+            +SH1122Commands::segment_remap | 0x00,
+            +SH1122Commands::com_scan_dir,
+            +SH1122Commands::set_contrast, 0x10,
+            +SH1122Commands::set_contrast, 0x70,
+            +SH1122Commands::set_multiplex, 0x3F,
+            +SH1122Commands::set_precharge, 0x92,
+            +SH1122Commands::set_vcom_deselect, 0x00,
+            +SH1122Commands::set_vsegm, 0x00,
+            +SH1122Commands::set_discharge_vsl | 0x06,
+            +SH1122Commands::display_all_on_resume,
+            +SH1122Commands::normal_display,
+            +SH1122Commands::display_on,
+        };
 
-            pio_sm_set_enabled(pio, pio_sm, true);
+        T_Transport transport{};
+
+        /// rendering stays one GS4 per pixel, swapBuffers packs into a free wire buffer.
+        /// the render buffer is never on the bus, so one suffices.
+        FrameBufferData frame_buffer_data{};
+        FrameBuffer frame_buffer{frame_buffer_data};
+
+        std::array<PackedFrame, 2> packed_frames{};
+        std::array<Plan, 2> plans{};
+        std::size_t packed_frame_idx{};
+
+        SH1122CostModel cost_model{};
+
+        /// packed frames queued or on the bus, decremented by their completion.
+        std::atomic<std::uint8_t> frames_in_flight{0};
+
+        /// frames not sent because both packed frames were still in flight.
+        std::size_t dropped_frames{};
+
+        /// called from the completion of every frame, in interrupt context on the pico.
+        void (*on_transfer_done)(void* p_context){};
+        void* on_transfer_done_context{};
+
+        void init()
+        {
+            transport.init();
+            transport.submit({
+                .kind = SH1122SegmentKind::command,
+                .data = init_commands.data(),
+                .size = init_commands.size(),
+            });
         }
 
-        void __time_critical_func(pioSpiWriteBlocking)(const std::uint8_t* p_src, std::size_t p_len)
+        void deinit()
         {
-            pioSpiWrite(p_src, p_len);
+            // TODO: add proper deinit stuff
+        }
 
-            dma_channel_wait_for_finish_blocking(dma_channel);
+        FrameBuffer& getBackBuffer()
+        {
+            return frame_buffer;
+        }
 
-            while (!pio_interrupt_get(pio, 0))
-            {
-                tight_loop_contents();
-            }
-            pio_interrupt_clear(pio, 0);
+        /// whether a packed frame is free, so the next swapBuffers won't drop.
+        bool isTransferDone()
+        {
+            transport.poll();
+            return frames_in_flight.load(std::memory_order_acquire) < packed_frames.size();
         }
-        
-        void __time_critical_func(pioSpiWrite)(const std::uint8_t* p_src, std::size_t p_len)
+
+        /// window covering the pixels p_x, p_y, p_width, p_height, clipped to the frame.
+        static constexpr SH1122Window getWindow(std::int32_t p_x, std::int32_t p_y, std::int32_t p_width, std::int32_t p_height)
         {
-            dma_channel_configure(
-                dma_channel,
-                &dma_config,
-                &pio->txf[pio_sm],
-                p_src,
-                p_len,
-                true);
+            const auto x0 = std::clamp<std::int32_t>(p_x, 0, width);
+            const auto y0 = std::clamp<std::int32_t>(p_y, 0, height);
+            const auto x1 = std::clamp<std::int32_t>(p_x + p_width, x0, width);
+            const auto y1 = std::clamp<std::int32_t>(p_y + p_height, y0, height);
+            return {
+                .row = static_cast<std::uint16_t>(y0),
+                .num_rows = static_cast<std::uint16_t>(y1 - y0),
+                .column = static_cast<std::uint16_t>(x0 / 2),
+                .num_columns = static_cast<std::uint16_t>((x1 + 1) / 2 - x0 / 2),
+            };
         }
 
+        /// pack the back buffer into a free wire buffer and queue it.
+        /// never blocks: with both packed frames in flight the frame is dropped
+        /// and false returned, await isTransferDone to avoid that.
+        bool swapBuffers()
+        {
+            const SH1122Window full{0, height, 0, columns};
+            return swapBuffers({&full, 1});
+        }
+
+        /// send only the p_dirty windows of the back buffer, merged under cost_model.
+        /// display memory outside them must already match the back buffer, so after
+        /// a dropped frame the next swap has to cover its windows too.
+        bool swapBuffers(std::span<const SH1122Window> p_dirty)
+        {
+            if (!isTransferDone())
+            {
+                ++dropped_frames;
+                return false;
+            }
+
+            const auto windows = planWindows<t_max_segments / 2>(p_dirty, columns, cost_model, t_max_segments);
+            if (windows.size == 0) { return true; }
+
+            auto& packed_frame = packed_frames[packed_frame_idx];
+            auto& plan = plans[packed_frame_idx];
+
+            for (const auto& window : windows.get())
+            {
+                for (std::size_t row = window.row; row < window.row + window.num_rows; ++row)
+                {
+                    const auto src = frame_buffer.rowBegin(row) + window.column * 2;
+                    packGS4(
+                        {src, src + window.num_columns * 2},
+                        {packed_frame.data() + row * columns + window.column, window.num_columns});
+                }
+            }
 
+            encodeWindows(windows.get(), packed_frame, columns, plan);
+            if (transport.getFreeSlots() < plan.num_segments)
+            {
+                ++dropped_frames;
+                return false;
+            }
+
+            auto& last = plan.segments[plan.num_segments - 1];
+            last.on_done = [](void* p_context){
+                auto& driver = *static_cast<SH1122Driver*>(p_context);
+                driver.frames_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+                if (driver.on_transfer_done != nullptr)
+                {
+                    driver.on_transfer_done(driver.on_transfer_done_context);
+                }
+            };
+            last.context = this;
+
+            // the free slots were checked and only this side pushes, so every submit succeeds.
+            frames_in_flight.fetch_add(1, std::memory_order_acq_rel);
+            for (const auto& segment : plan.get())
+            {
+                transport.submit(segment);
+            }
+
+            packed_frame_idx = (packed_frame_idx + 1) % packed_frames.size();
+            return true;
+        }
     };
 
 } // namespace picon::drivers
-
-#endif
\ No newline at end of file
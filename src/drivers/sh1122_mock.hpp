@@ -0,0 +1,121 @@
+#pragma once
+
+#if defined(PICON_PLATFORM_LINUX)
+#include "sh1122.hpp"
+
+#include "time/time.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace picon::drivers
+{
+
+    /// host SH1122 transport.
+    /// records the byte stream and completes segments after the time the
+    /// real bus would need, so protocol and queueing run without hardware.
+    /// every completed segment is also applied to a model of the display memory.
+    template <std::size_t t_queue_size = 32>
+    struct SH1122MockTransport
+    {
+        struct Record
+        {
+            SH1122SegmentKind kind{};
+            std::vector<std::uint8_t> bytes{};
+            std::uint64_t start_us{};
+            std::uint64_t end_us{};
+        };
+
+        /// time source, swap in async::VirtualClock::now to step transfers manually.
+        std::uint64_t (*clock)() = time::getEpochTimeUs64;
+
+        /// pio clock / 2 cycles per bit at the default 125 MHz and divider 4.
+        std::uint64_t bits_per_second{15'625'000};
+
+        /// keep a copy of every segment in records.
+        bool record{true};
+        std::vector<Record> records{};
+
+        /// display memory as the sent stream leaves it.
+        SH1122Gram<> gram{};
+
+        std::uint64_t bytes_sent{};
+        std::uint64_t busy_us{};
+
+        SH1122SegmentQueue<t_queue_size> queue{};
+        bool active{false};
+        std::uint64_t active_start_us{};
+        std::uint64_t active_end_us{};
+
+        void init() {}
+
+        bool submit(const SH1122Segment& p_segment)
+        {
+            poll();
+            if (!queue.push(p_segment)) { return false; }
+            if (!active) { startFront(clock()); }
+            return true;
+        }
+
+        /// complete every segment whose simulated transfer has ended.
+        void poll()
+        {
+            const auto now = clock();
+            while (active && active_end_us <= now)
+            {
+                const auto segment = queue.front();
+                queue.pop();
+                active = false;
+
+                gram.apply(segment);
+                bytes_sent += segment.size;
+                busy_us += active_end_us - active_start_us;
+                if (record)
+                {
+                    records.push_back({
+                        .kind = segment.kind,
+                        .bytes = {segment.data, segment.data + segment.size},
+                        .start_us = active_start_us,
+                        .end_us = active_end_us,
+                    });
+                }
+
+                if (segment.on_done != nullptr)
+                {
+                    segment.on_done(segment.context);
+                }
+
+                if (!queue.empty()) { startFront(active_end_us); }
+            }
+        }
+
+        bool isIdle() const
+        {
+            return !active;
+        }
+
+        std::size_t getFreeSlots() const
+        {
+            return t_queue_size - queue.size();
+        }
+
+        /// simulated bus time of p_segment.
+        std::uint64_t getTransferUs(const SH1122Segment& p_segment) const
+        {
+            return (p_segment.size * 8 * 1'000'000 + bits_per_second - 1) / bits_per_second;
+        }
+
+    private:
+        void startFront(std::uint64_t p_start_us)
+        {
+            active = true;
+            active_start_us = p_start_us;
+            active_end_us = p_start_us + getTransferUs(queue.front());
+        }
+    };
+
+} // namespace picon::drivers
+
+#endif
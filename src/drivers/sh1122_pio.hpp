@@ -0,0 +1,246 @@
+#pragma once
+
+#if defined(PICON_PLATFORM_PICO)
+#include "sh1122.hpp"
+
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+#include <hardware/pio.h>
+#include <hardware/pio_instructions.h>
+#include <hardware/sync.h>
+#include <pico.h>
+#include <pico/platform/common.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace picon::drivers
+{
+
+    /// SH1122 transport over a PIO spi state machine fed by DMA.
+    /// segments are chained from the DMA completion interrupt, so the cpu
+    /// only touches the bus between segments.
+    /// commands and packed pixel data both shift all 8 bits of every byte,
+    /// only the dc line tells them apart.
+    template <
+        std::uint8_t t_sck,
+        std::uint8_t t_mosi,
+        std::uint8_t t_dc,
+        std::uint8_t t_cs,
+        std::uint8_t t_rst,
+        std::size_t t_queue_size = 32>
+    struct SH1122PioTransport
+    {
+        static constexpr auto sck = t_sck;
+        static constexpr auto mosi = t_mosi;
+        static constexpr auto dc = t_dc;
+        static constexpr auto cs = t_cs;
+        static constexpr auto rst = t_rst;
+
+        PIO pio{};
+        uint pio_sm{};
+        uint pio_offset{};
+
+        std::uint8_t dma_channel{};
+        dma_channel_config dma_config{};
+
+        SH1122SegmentQueue<t_queue_size> queue{};
+        /// whether the queue front is on the bus.
+        volatile bool active{false};
+        SH1122SegmentKind mode{SH1122SegmentKind::command};
+
+        void init()
+        {
+            instance = this;
+            initSpiPio(pio);
+            initDma();
+            initGpio();
+        }
+
+        bool submit(const SH1122Segment& p_segment)
+        {
+            if (!queue.push(p_segment)) { return false; }
+
+            // the completion interrupt may be chaining the next segment right now.
+            const auto interrupts = save_and_disable_interrupts();
+            if (!active) { startFront(); }
+            restore_interrupts(interrupts);
+            return true;
+        }
+
+        /// completions are interrupt driven.
+        void poll() {}
+
+        bool isIdle() const
+        {
+            return !active;
+        }
+
+        std::size_t getFreeSlots() const
+        {
+            return t_queue_size - queue.size();
+        }
+
+    private:
+        static inline SH1122PioTransport* instance{};
+
+        static void __time_critical_func(onDmaIrq)()
+        {
+            if (!dma_channel_get_irq0_status(instance->dma_channel)) { return; }
+            dma_channel_acknowledge_irq0(instance->dma_channel);
+            instance->onSegmentDone();
+        }
+
+        void __time_critical_func(onSegmentDone)()
+        {
+            const auto segment = queue.front();
+            queue.pop();
+
+            if (segment.on_done != nullptr)
+            {
+                segment.on_done(segment.context);
+            }
+
+            if (queue.empty())
+            {
+                waitForDrain();
+                deselectDevice();
+                active = false;
+                return;
+            }
+            startFront();
+        }
+
+        void __time_critical_func(startFront)()
+        {
+            const auto& segment = queue.front();
+            active = true;
+
+            if (segment.kind != mode)
+            {
+                // dc may only change once the last bit of the previous segment is out.
+                waitForDrain();
+                gpio_put(dc, segment.kind == SH1122SegmentKind::data);
+                mode = segment.kind;
+            }
+
+            selectDevice();
+            dma_channel_configure(
+                dma_channel,
+                &dma_config,
+                &pio->txf[pio_sm],
+                segment.data,
+                segment.size,
+                true);
+        }
+
+        /// wait until the last byte has been shifted out, a few bit times after the dma finished.
+        /// the state machine stalls on its next pull once fifo and shift register are empty.
+        void __time_critical_func(waitForDrain)()
+        {
+            while (!pio_sm_is_tx_fifo_empty(pio, pio_sm))
+            {
+                tight_loop_contents();
+            }
+
+            const auto tx_stall = 1u << (PIO_FDEBUG_TXSTALL_LSB + pio_sm);
+            pio->fdebug = tx_stall;
+            while (!(pio->fdebug & tx_stall))
+            {
+                tight_loop_contents();
+            }
+        }
+
+        void selectDevice()
+        {
+            gpio_put(cs, 0);
+        }
+
+        void deselectDevice()
+        {
+            gpio_put(cs, 1);
+        }
+
+        void initGpio()
+        {
+            gpio_init(dc);
+            gpio_init(cs);
+            gpio_init(rst);
+            gpio_set_dir(dc, GPIO_OUT);
+            gpio_set_dir(cs, GPIO_OUT);
+            gpio_set_dir(rst, GPIO_OUT);
+            gpio_put(rst, 1);
+            gpio_put(cs, 1);
+            gpio_put(dc, 0);
+        }
+
+        void initDma()
+        {
+            dma_channel = dma_claim_unused_channel(true);
+            dma_config = dma_channel_get_default_config(dma_channel);
+            channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_8);
+            channel_config_set_dreq(&dma_config, pio_get_dreq(pio, pio_sm, true));
+
+            dma_channel_set_irq0_enabled(dma_channel, true);
+            irq_add_shared_handler(DMA_IRQ_0, onDmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+            irq_set_enabled(DMA_IRQ_0, true);
+        }
+
+        void initSpiPio(PIO p_pio)
+        {
+            pio = p_pio;
+
+            // one byte msb first, data latched on the rising clock edge.
+            static const std::array<std::uint16_t, 3> instructions{
+                static_cast<std::uint16_t>(
+                    pio_encode_set(pio_src_dest::pio_x, 7) |
+                    pio_encode_sideset(1, 0)),
+                static_cast<std::uint16_t>(
+                    pio_encode_out(pio_src_dest::pio_pins, 1) |
+                    pio_encode_sideset(1, 0)),
+                static_cast<std::uint16_t>(
+                    pio_encode_jmp_x_dec(1) |
+                    pio_encode_sideset(1, 1)),
+            };
+
+            const pio_program program {
+                .instructions = instructions.data(),
+                .length = static_cast<std::uint8_t>(instructions.size()),
+                .origin = -1,
+                .pio_version = 0,
+            };
+
+            pio_sm = pio_claim_unused_sm(pio, true);
+
+            pio_offset = pio_add_program(pio, &program);
+            auto config{pio_get_default_sm_config()};
+
+            sm_config_set_wrap(&config, pio_offset, pio_offset + instructions.size() - 1);
+
+            sm_config_set_sideset(&config, 1, false, false);
+            sm_config_set_out_shift(&config, false, true, 8);
+            sm_config_set_in_shift(&config, false, false, 8);
+            // sm_config_set_clkdiv_int_frac8(&config, 5, 0);
+            sm_config_set_clkdiv_int_frac8(&config, 4, 0);
+            // sm_config_set_clkdiv_int_frac8(&config, 3, 0);
+            // sm_config_set_clkdiv_int_frac8(&config, 2, 0);
+
+            sm_config_set_out_pins(&config, mosi, 1);
+            sm_config_set_sideset_pins(&config, sck);
+
+            pio_sm_set_pins_with_mask(pio, pio_sm, 0, (1u << sck) | (1u << mosi));
+            pio_sm_set_pindirs_with_mask(pio, pio_sm, -1, (1u << sck) | (1u << mosi));
+            pio_gpio_init(pio, mosi);
+            pio_gpio_init(pio, sck);
+
+            pio_sm_init(pio, pio_sm, pio_offset, &config);
+
+            pio_sm_set_enabled(pio, pio_sm, true);
+        }
+    };
+
+} // namespace picon::drivers
+
+#endif
@@ -0,0 +1,375 @@
+#pragma once
+
+#if defined(PICON_PLATFORM_LINUX)
+
+#include "drivers/capture.hpp"
+#include "graphics/color.hpp"
+#include "graphics/image.hpp"
+#include "time/time.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+namespace picon::drivers
+{
+
+    /// layout of the shared memory segment ShmDriver publishes frames through.
+    /// a Header, then num_buffers frame buffers of buffer_stride bytes from pixels_offset.
+    namespace shm
+    {
+        /// "pcon", stored last so a half initialized segment is never opened.
+        inline constexpr std::uint32_t magic = 0x6e6f6370;
+        inline constexpr std::uint32_t version = 1;
+        inline constexpr std::size_t max_buffers = 8;
+
+        /// seqlock of one frame buffer, odd while the producer draws into it.
+        struct alignas(64) Slot
+        {
+            std::atomic<std::uint32_t> sequence{};
+            /// number and swap time of the frame last published from this buffer.
+            std::atomic<std::uint64_t> frame{};
+            std::atomic<std::uint64_t> timestamp_us{};
+        };
+
+        struct Header
+        {
+            std::atomic<std::uint32_t> magic{};
+            std::uint32_t version{};
+            std::uint32_t width{};
+            std::uint32_t height{};
+            std::uint32_t pixel_size{};
+            std::array<char, 16> format{};
+            std::uint32_t num_buffers{};
+            std::uint32_t pixels_offset{};
+            std::uint32_t buffer_stride{};
+
+            /// frames published so far, readers futex wait on it.
+            alignas(64) std::atomic<std::uint32_t> frame_counter{};
+            /// buffer holding the latest published frame.
+            std::atomic<std::uint32_t> latest{};
+
+            std::array<Slot, max_buffers> slots{};
+        };
+
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free && sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        /// sleep until p_word isn't p_expected, p_timeout_us passed or a spurious wakeup.
+        /// a shared futex, std::atomic::wait only wakes waiters of the same process.
+        inline void futexWait(const std::atomic<std::uint32_t>& p_word, std::uint32_t p_expected, std::uint64_t p_timeout_us)
+        {
+            const timespec timeout{
+                static_cast<std::time_t>(p_timeout_us / 1'000'000),
+                static_cast<long>(p_timeout_us % 1'000'000 * 1'000),
+            };
+            syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&p_word), FUTEX_WAIT, p_expected, &timeout, nullptr, 0);
+        }
+
+        inline void futexWakeAll(const std::atomic<std::uint32_t>& p_word)
+        {
+            syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&p_word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        template <graphics::color::ColorType T_Color>
+        constexpr std::array<char, 16> formatName()
+        {
+            constexpr auto name = graphics::color::name<T_Color>;
+            static_assert(name.size() <= 16);
+            std::array<char, 16> format{};
+            std::copy(name.begin(), name.end(), format.begin());
+            return format;
+        }
+
+        /// buffers start on cache lines, and the first one on a page.
+        inline constexpr std::size_t pixels_offset = (sizeof(Header) + 4095) / 4096 * 4096;
+
+        template <graphics::color::ColorType T_Color, std::size_t t_width, std::size_t t_height>
+        inline constexpr std::size_t buffer_stride = (t_width * t_height * sizeof(T_Color) + 63) / 64 * 64;
+    } // namespace shm
+
+
+    /// headless display that renders straight into frame buffers in a POSIX
+    /// shared memory segment, for other processes to map and read without copies.
+    /// every buffer has a seqlock and swapBuffers publishes by bumping a futex,
+    /// so readers can sleep until the next frame. the producer never waits on
+    /// readers: buffers are reused round robin, a published frame stays intact
+    /// for t_num_buffers - 1 swaps and readers that take longer see a torn read.
+    /// the back buffer holds the frame from t_num_buffers swaps ago, so the
+    /// whole frame must be redrawn.
+    /// see ShmFrameReader and shm_viewer.cpp for the reading side.
+    template <graphics::color::ColorType T_Color, std::size_t t_width, std::size_t t_height, std::size_t t_num_buffers = 4>
+    requires(t_num_buffers >= 2 && t_num_buffers <= shm::max_buffers)
+    struct ShmDriver
+    {
+        // static
+        using FrameBuffer = graphics::Image<T_Color>;
+        using Capture = FrameCapture<T_Color, t_width, t_height>;
+
+        constexpr static std::size_t width = t_width;
+        constexpr static std::size_t height = t_height;
+        constexpr static std::size_t num_frame_buffers = t_num_buffers;
+
+        constexpr static std::size_t buffer_stride = shm::buffer_stride<T_Color, t_width, t_height>;
+        constexpr static std::size_t segment_size = shm::pixels_offset + buffer_stride * t_num_buffers;
+
+        // instance
+        /// name of the segment, /dev/shm/picon by default.
+        const char* name{"/picon"};
+
+        /// every swapped frame is pushed here when set.
+        Capture* capture{};
+
+        /// never called, transfers complete in swapBuffers.
+        void (*on_transfer_done)(void* p_context){};
+        void* on_transfer_done_context{};
+
+        std::uint32_t published_frames{};
+
+    private:
+        int fd{-1};
+        std::uint8_t* map{};
+        shm::Header* header{};
+        FrameBuffer back_buffer{t_width, t_height, nullptr};
+        std::size_t back_buffer_idx{0};
+
+    public:
+        /// create a fresh segment, readers of a previous one keep their mapping
+        /// and see no more frames.
+        void init()
+        {
+            shm_unlink(name);
+            fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0 || ftruncate(fd, segment_size) != 0)
+            {
+                std::perror("Could not create shared memory segment");
+                abort();
+            }
+
+            map = static_cast<std::uint8_t*>(mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+            if (map == MAP_FAILED)
+            {
+                std::perror("Could not map shared memory segment");
+                abort();
+            }
+
+            header = new (map) shm::Header{};
+            header->version = shm::version;
+            header->width = t_width;
+            header->height = t_height;
+            header->pixel_size = sizeof(T_Color);
+            header->format = shm::formatName<T_Color>();
+            header->num_buffers = t_num_buffers;
+            header->pixels_offset = shm::pixels_offset;
+            header->buffer_stride = buffer_stride;
+            header->latest.store(t_num_buffers - 1, std::memory_order_relaxed);
+            header->magic.store(shm::magic, std::memory_order_release);
+
+            beginWrite(back_buffer_idx);
+        }
+
+        void deinit()
+        {
+            munmap(map, segment_size);
+            close(fd);
+            shm_unlink(name);
+            map = nullptr;
+            header = nullptr;
+            fd = -1;
+        }
+
+        /// the returned view points into the segment.
+        FrameBuffer& getBackBuffer()
+        {
+            return back_buffer;
+        }
+
+        /// always true, publishing never waits on readers.
+        bool isTransferDone() const
+        {
+            return true;
+        }
+
+        /// publish the back buffer and wake waiting readers.
+        void swapBuffers()
+        {
+            if (capture != nullptr)
+            {
+                capture->push(back_buffer);
+            }
+
+            auto& slot = header->slots[back_buffer_idx];
+            slot.frame.store(++published_frames, std::memory_order_relaxed);
+            slot.timestamp_us.store(time::getEpochTimeUs64(), std::memory_order_relaxed);
+            slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+            header->latest.store(back_buffer_idx, std::memory_order_release);
+            header->frame_counter.store(published_frames, std::memory_order_release);
+            shm::futexWakeAll(header->frame_counter);
+
+            back_buffer_idx = (back_buffer_idx + 1) % t_num_buffers;
+            beginWrite(back_buffer_idx);
+        }
+
+    private:
+        /// make the sequence of buffer p_idx odd before anything is drawn into it.
+        void beginWrite(std::size_t p_idx)
+        {
+            auto& slot = header->slots[p_idx];
+            slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            back_buffer = FrameBuffer{t_width, t_height, reinterpret_cast<T_Color*>(map + shm::pixels_offset + p_idx * buffer_stride)};
+        }
+    };
+
+
+    /// maps a ShmDriver segment read only and reads its latest frame in place.
+    template <graphics::color::ColorType T_Color, std::size_t t_width, std::size_t t_height>
+    struct ShmFrameReader
+    {
+        using FrameBuffer = graphics::Image<T_Color>;
+
+        struct Frame
+        {
+            std::uint64_t frame;
+            std::uint64_t timestamp_us;
+        };
+
+    private:
+        int fd{-1};
+        const std::uint8_t* map{};
+        std::size_t map_size{};
+        const shm::Header* header{};
+
+    public:
+        /// map segment p_name, false while it doesn't exist yet or holds another format.
+        bool open(const char* p_name)
+        {
+            close();
+
+            fd = shm_open(p_name, O_RDONLY, 0);
+            struct stat info{};
+            if (fd < 0 || fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(shm::Header))
+            {
+                close();
+                return false;
+            }
+
+            map_size = info.st_size;
+            const auto mapped = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                close();
+                return false;
+            }
+            map = static_cast<const std::uint8_t*>(mapped);
+            header = reinterpret_cast<const shm::Header*>(map);
+
+            if (header->magic.load(std::memory_order_acquire) != shm::magic ||
+                header->version != shm::version)
+            {
+                close();
+                return false;
+            }
+
+            if (header->width != t_width ||
+                header->height != t_height ||
+                header->pixel_size != sizeof(T_Color) ||
+                header->format != shm::formatName<T_Color>())
+            {
+                std::fprintf(stderr, "Shared memory segment %s holds %ux%u %s frames, expected %zux%zu %s\n",
+                    p_name,
+                    header->width, header->height, header->format.data(),
+                    t_width, t_height, graphics::color::name<T_Color>.data());
+                close();
+                return false;
+            }
+
+            // every frame buffer must hold a whole frame and lie inside the mapping.
+            if (header->num_buffers == 0 ||
+                header->num_buffers > shm::max_buffers ||
+                header->buffer_stride < t_width * t_height * sizeof(T_Color) ||
+                header->pixels_offset < sizeof(shm::Header) ||
+                header->pixels_offset + static_cast<std::size_t>(header->num_buffers) * header->buffer_stride > map_size)
+            {
+                std::fprintf(stderr, "Shared memory segment %s has %u buffers of %u bytes at %u in %zu bytes, a frame takes %zu\n",
+                    p_name,
+                    header->num_buffers, header->buffer_stride, header->pixels_offset, map_size,
+                    t_width * t_height * sizeof(T_Color));
+                close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void close()
+        {
+            if (map != nullptr) { munmap(const_cast<std::uint8_t*>(map), map_size); }
+            if (fd >= 0) { ::close(fd); }
+            fd = -1;
+            map = nullptr;
+            map_size = 0;
+            header = nullptr;
+        }
+
+        bool isOpen() const
+        {
+            return header != nullptr;
+        }
+
+        /// frames published so far.
+        std::uint32_t getFrameCounter() const
+        {
+            return header->frame_counter.load(std::memory_order_acquire);
+        }
+
+        /// sleep until the frame counter moves past p_seen or p_timeout_us passed,
+        /// returns the frame counter.
+        std::uint32_t waitFrame(std::uint32_t p_seen, std::uint64_t p_timeout_us) const
+        {
+            if (const auto counter = getFrameCounter(); counter != p_seen) { return counter; }
+            shm::futexWait(header->frame_counter, p_seen, p_timeout_us);
+            return getFrameCounter();
+        }
+
+        /// call p_read(const FrameBuffer&, Frame) on the latest frame where it lies in the segment.
+        /// returns false if the producer started overwriting it meanwhile,
+        /// then whatever p_read made of it is torn and must be dropped.
+        template <typename T_Read>
+        bool read(T_Read&& p_read) const
+        {
+            const auto idx = header->latest.load(std::memory_order_acquire) % header->num_buffers;
+            const auto& slot = header->slots[idx];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) { return false; }
+
+            const Frame frame{
+                slot.frame.load(std::memory_order_relaxed),
+                slot.timestamp_us.load(std::memory_order_relaxed),
+            };
+            const FrameBuffer pixels{t_width, t_height, reinterpret_cast<T_Color*>(const_cast<std::uint8_t*>(map + header->pixels_offset + idx * header->buffer_stride))};
+            p_read(pixels, frame);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.sequence.load(std::memory_order_relaxed) == sequence;
+        }
+    };
+
+} // namespace picon::drivers
+
+#endif
@@ -3,17 +3,79 @@
 #include "color.hpp"
 #include "convert.hpp"
 
+#include <cstddef>
+
 namespace picon::graphics::color::blend
 {
+    /// blend mode that also takes the destination pixel position,
+    /// e.g. for ordered dithering.
     template <typename T_BlendMode, typename T_DstColor, typename T_SrcColor>
-    concept BlendMode =
+    concept PositionalBlendMode =
         ColorType<T_DstColor> &&
         ColorType<T_SrcColor> &&
-        requires(T_DstColor dst, T_SrcColor src, T_BlendMode blend)
+        requires(T_DstColor dst, T_SrcColor src, T_BlendMode blend, std::size_t x, std::size_t y)
         {
-            { blend(dst, src) };
+            { blend(dst, src, x, y) };
         };
 
+    template <typename T_BlendMode, typename T_DstColor, typename T_SrcColor>
+    concept BlendMode =
+        ColorType<T_DstColor> &&
+        ColorType<T_SrcColor> &&
+        (
+            requires(T_DstColor dst, T_SrcColor src, T_BlendMode blend)
+            {
+                { blend(dst, src) };
+            } ||
+            PositionalBlendMode<T_BlendMode, T_DstColor, T_SrcColor>
+        );
+
+    /// apply p_blend to a pixel at p_x, p_y, passing the position only if the blend mode takes it.
+    template <typename T_BlendMode, ColorType T_DstColor, ColorType T_SrcColor>
+    constexpr void apply(T_BlendMode& p_blend, T_DstColor& r_dst, T_SrcColor p_src, std::size_t p_x, std::size_t p_y)
+    {
+        if constexpr (PositionalBlendMode<T_BlendMode, T_DstColor, T_SrcColor>)
+        {
+            p_blend(r_dst, p_src, p_x, p_y);
+        }
+        else
+        {
+            p_blend(r_dst, p_src);
+        }
+    }
+
+    /// blend mode that precomputes per format, e.g. lookup tables, in bind<T_DstColor, T_SrcColor>().
+    template <typename T_BlendMode, typename T_DstColor, typename T_SrcColor>
+    concept BindableBlendMode = requires(const T_BlendMode blend)
+    {
+        blend.template bind<T_DstColor, T_SrcColor>();
+    };
+
+    /// the blend mode to run per pixel of a T_DstColor, T_SrcColor draw.
+    /// bound once per draw if it precomputes, the rest are used as they are.
+    template <ColorType T_DstColor, ColorType T_SrcColor, typename T_BlendMode>
+    constexpr decltype(auto) bind(T_BlendMode& p_blend)
+    {
+        if constexpr (BindableBlendMode<T_BlendMode, T_DstColor, T_SrcColor>)
+        {
+            return p_blend.template bind<T_DstColor, T_SrcColor>();
+        }
+        else
+        {
+            return (p_blend);
+        }
+    }
+
+    /// whether T_BlendMode overwrites the destination with a source pixel of full
+    /// alpha, so anything drawn beneath such a pixel can be skipped.
+    /// false for modes that read the destination.
+    template <typename T_BlendMode>
+    inline constexpr bool replaces_opaque = false;
+
+    /// whether T_BlendMode overwrites the destination whatever the source alpha.
+    template <typename T_BlendMode>
+    inline constexpr bool replaces_always = false;
+
     constexpr struct None
     {
         template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
@@ -23,6 +85,9 @@ namespace picon::graphics::color::blend
         }
     } none;
 
+    template <> inline constexpr bool replaces_opaque<None> = true;
+    template <> inline constexpr bool replaces_always<None> = true;
+
 
     constexpr struct Alpha
     {
@@ -41,4 +106,6 @@ namespace picon::graphics::color::blend
         }
     } alpha;
 
+    template <> inline constexpr bool replaces_opaque<Alpha> = true;
+
 } // namespace picon::graphics::blend
\ No newline at end of file
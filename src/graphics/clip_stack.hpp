@@ -0,0 +1,88 @@
+#pragma once
+
+#include "color.hpp"
+#include "image.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace picon::graphics
+{
+
+    /// nested clipping of an Image, e.g. a scrolling panel inside a window.
+    /// each push narrows the target's scissor to its intersection with the rect,
+    /// each pop restores the scissor from before the matching push.
+    /// pushes beyond t_depth clip everything until popped, so overflow draws
+    /// too little rather than outside the panel.
+    /// @tparam T_Format
+    /// @tparam t_depth
+    template <color::ColorType T_Format, std::size_t t_depth = 8>
+    struct ClipStack
+    {
+        using Rect = Image<T_Format>::Rect;
+
+        constexpr static auto depth = t_depth;
+
+        Image<T_Format>* target;
+
+        std::array<Rect, t_depth> saved{};
+        std::size_t num_saved{};
+        std::size_t num_overflowed{};
+        Rect overflowed_scissor{};
+
+        constexpr ClipStack(Image<T_Format>& r_target) : target{&r_target} {}
+
+        /// returns whether anything inside p_rect is visible, so a whole group of
+        /// draws can be skipped with one test. push and pop must pair either way.
+        constexpr bool push(Rect p_rect)
+        {
+            if (num_saved == t_depth)
+            {
+                assert(false && "clip stack overflow");
+                if (num_overflowed++ == 0) { overflowed_scissor = target->scissor; }
+                target->scissor = {};
+                return false;
+            }
+
+            saved[num_saved++] = target->scissor;
+            const auto scissor = target->scissor.intersect(p_rect);
+            target->scissor = scissor && !scissor->empty() ? *scissor : Rect{};
+            return !target->scissor.empty();
+        }
+
+        constexpr void pop()
+        {
+            if (num_overflowed > 0)
+            {
+                if (--num_overflowed == 0) { target->scissor = overflowed_scissor; }
+                return;
+            }
+
+            assert(num_saved > 0);
+            if (num_saved > 0) { target->scissor = saved[--num_saved]; }
+        }
+
+        constexpr std::size_t size() const
+        {
+            return num_saved + num_overflowed;
+        }
+    };
+
+    static_assert([](){
+        std::array<color::GS4, 16 * 8> pixels{};
+        Image<color::GS4> image{16, 8, pixels.data()};
+        ClipStack<color::GS4, 2> clip{image};
+
+        if (!clip.push({{2, 2}, {20, 4}})) { return false; }
+        if (image.scissor.position.x != 2 || image.scissor.size.x != 14 || image.scissor.size.y != 4) { return false; }
+
+        if (clip.push({{0, 7}, {4, 4}})) { return false; }
+        if (!image.scissor.empty()) { return false; }
+        clip.pop();
+
+        clip.pop();
+        return !image.isClipped() && clip.size() == 0;
+    }());
+
+} // namespace picon::graphics
@@ -3,8 +3,10 @@
 #include "utils/bit_utils.hpp"
 #include "utils/traits.hpp"
 
+#include <array>
 #include <climits>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
 #include <type_traits>
@@ -23,6 +25,8 @@ namespace picon::graphics::color
     struct B: public Channel{};
     struct A: public Channel{};
     struct L: public Channel{};
+    /// palette index.
+    struct I: public Channel{};
 
 
     template <typename T_Type>
@@ -58,6 +62,9 @@ namespace picon::graphics::color
         /// total number of channels.
         constexpr static std::size_t num_channels = sizeof...(t_channels);
 
+        /// bits used by all channels, counted from the lsb.
+        constexpr static std::size_t num_bits = ((t_channels.size + t_channels.offset) + ... + 0);
+
         /// whether or not color has the given channel type.
         template <ChannelType T_Channel>
         constexpr static bool has_channel
@@ -160,6 +167,38 @@ namespace picon::graphics::color
     using R4G4B4A4 = Color<std::uint16_t, R{4}, G{4}, B{4}, A{4}>;
     using R8G8B8 = Color<std::uint32_t, R{8}, G{8}, B{8}>;
     using R8G8B8A8 = Color<std::uint32_t, R{8}, G{8}, B{8}, A{8}>;
+    using I4 = Color<std::uint8_t, I{4}>;
+    using I8 = Color<std::uint8_t, I{8}>;
+
+
+    namespace internal
+    {
+        template <ChannelType T_Channel>
+        constexpr char channelLetter()
+        {
+            if constexpr (ChannelOfType<R, T_Channel>) { return 'R'; }
+            else if constexpr (ChannelOfType<G, T_Channel>) { return 'G'; }
+            else if constexpr (ChannelOfType<B, T_Channel>) { return 'B'; }
+            else if constexpr (ChannelOfType<A, T_Channel>) { return 'A'; }
+            else if constexpr (ChannelOfType<L, T_Channel>) { return 'L'; }
+            else { return 'I'; }
+        }
+    } // namespace internal
+
+    /// e.g. "R5G5B5A1", from the channel metadata, null terminated.
+    template <ColorType T_Color>
+    inline constexpr auto name = []<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>)
+    {
+        std::array<char, T_Color::num_channels * 3 + 1> name{};
+        std::size_t i = 0;
+        ([&]()
+        {
+            name[i++] = internal::channelLetter<decltype(t_channels)>();
+            if (t_channels.size >= 10) { name[i++] = static_cast<char>('0' + t_channels.size / 10); }
+            name[i++] = static_cast<char>('0' + t_channels.size % 10);
+        }(), ...);
+        return name;
+    }(T_Color{});
 
 
     static_assert(R5G5B5A1{1, 2, 3, 1}.get<R>() == 1);
@@ -189,7 +228,19 @@ namespace picon::graphics::color
     static_assert(!GS4::has_channel<B>);
     static_assert(!GS4::has_channel<A>);
 
+    static_assert(GS4::num_bits == 4);
+    static_assert(GS4A1::num_bits == 5);
+    static_assert(R5G6B5::num_bits == 16);
+
     static_assert(GS4::channel<L>.size == 4);
     static_assert(GS4::channel<L>.offset == 4);
 
+    static_assert(I4::has_channel<I>);
+    static_assert(!I4::has_channel<L>);
+    static_assert(I4::channel<I>.size == 4);
+    static_assert(I8::channel<I>.size == 8);
+
+    static_assert(name<R5G5B5A1>[0] == 'R' && name<R5G5B5A1>[7] == '1' && name<R5G5B5A1>[8] == '\0');
+    static_assert(name<GS4>[0] == 'L' && name<GS4>[1] == '4' && name<GS4>[2] == '\0');
+
 } // namespace picon::graphics::color
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <hardware/interp.h>
 #endif
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 
@@ -68,24 +69,292 @@ namespace picon::graphics::color
     template <typename T_Type>
     concept BypassCustomType = std::same_as<BypassCustom, T_Type>;
 
+    /// platform costs for choosing between a conversion table and arithmetic.
+    struct ConvertCostModel
+    {
+        /// largest conversion table worth its memory.
+        std::size_t max_lut_bytes{};
+        /// tables up to this size mostly hit the cache.
+        std::size_t cache_bytes{};
+        std::size_t lut_hit_cycles{};
+        std::size_t lut_miss_cycles{};
+        /// extracting, resizing and inserting one channel.
+        std::size_t channel_cycles{};
+        /// the weighted rgb sum of luminance, dominated by its 64 bit division.
+        std::size_t luminance_cycles{};
+    };
+
+    #if defined(PICON_PLATFORM_PICO)
+        #if !defined(PICON_CONVERT_MAX_LUT_BYTES)
+        #define PICON_CONVERT_MAX_LUT_BYTES (64 * 1024)
+        #endif
+
+        /// tables are const and read from flash through the 16 KiB xip cache,
+        /// the m0+ divides 64 bit values in software.
+        inline constexpr ConvertCostModel convert_cost_model{
+            .max_lut_bytes = PICON_CONVERT_MAX_LUT_BYTES,
+            .cache_bytes = 16 * 1024,
+            .lut_hit_cycles = 3,
+            .lut_miss_cycles = 24,
+            .channel_cycles = 6,
+            .luminance_cycles = 140,
+        };
+    #else
+        #if !defined(PICON_CONVERT_MAX_LUT_BYTES)
+        #define PICON_CONVERT_MAX_LUT_BYTES (128 * 1024)
+        #endif
+
+        inline constexpr ConvertCostModel convert_cost_model{
+            .max_lut_bytes = PICON_CONVERT_MAX_LUT_BYTES,
+            .cache_bytes = 32 * 1024,
+            .lut_hit_cycles = 4,
+            .lut_miss_cycles = 14,
+            .channel_cycles = 2,
+            .luminance_cycles = 30,
+        };
+    #endif
+
+    /// table of every T_DstColor for every T_SrcColor value.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    using ConvertLut = std::array<T_DstColor, utils::bits<T_SrcColor::num_bits> + 1>;
+
+    /// estimated cycles of converting arithmetically.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr std::size_t convert_arithmetic_cycles = [](){
+        if constexpr (std::same_as<T_DstColor, T_SrcColor>)
+        {
+            return 0;
+        }
+        else if constexpr (T_DstColor::template has_channel<L> && num_color_channels<T_SrcColor> == 3)
+        {
+            return 3 * convert_cost_model.channel_cycles + convert_cost_model.luminance_cycles +
+                T_DstColor::template has_channel<A> * convert_cost_model.channel_cycles;
+        }
+        else
+        {
+            return T_DstColor::num_channels * convert_cost_model.channel_cycles;
+        }
+    }();
+
+    /// bytes of the conversion table, wider sources never get one.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr std::size_t convert_lut_bytes = [](){
+        if constexpr (T_SrcColor::num_bits <= 16) { return sizeof(ConvertLut<T_DstColor, T_SrcColor>); }
+        else { return SIZE_MAX; }
+    }();
+
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr std::size_t convert_lut_cycles =
+        convert_lut_bytes<T_DstColor, T_SrcColor> <= convert_cost_model.cache_bytes ?
+            convert_cost_model.lut_hit_cycles :
+            convert_cost_model.lut_miss_cycles;
+
+    /// luminance contribution of every value of a t_bits channel, rec. 601 weight
+    /// on the channel expanded to 8 bits as the arithmetic conversion does.
+    template <std::size_t t_bits, std::uint32_t t_weight>
+    inline constexpr auto luminance_channel_lut = [](){
+        std::array<std::uint32_t, utils::bits<t_bits> + 1> lut{};
+        for (std::size_t i = 0; i < lut.size(); ++i)
+        {
+            lut[i] = static_cast<std::uint32_t>(utils::resizeBits<8, t_bits>(static_cast<std::uintmax_t>(i))) * t_weight;
+        }
+        return lut;
+    }();
+
+    /// p_n / 1000 as multiply and shift, exact up to 15937, the largest luminance sum shifted down to 4 bits.
+    constexpr std::uint32_t divideBy1000(std::uint32_t p_n)
+    {
+        return (p_n * 8389) >> 23;
+    }
+
+    static_assert([](){
+        for (std::uint32_t n = 0; n <= (255 * 1000) >> 4; ++n)
+        {
+            if (divideBy1000(n) != n / 1000) { return false; }
+        }
+        return true;
+    }());
+
+    /// whether rgb to luminance can go through luminance_channel_lut, which needs
+    /// channels of at most 8 bits and a luminance of at most 4 bits for divideBy1000.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr bool convert_channel_lut_fits = [](){
+        if constexpr (
+            num_color_channels<T_DstColor> == 1 && T_DstColor::template has_channel<L> &&
+            num_color_channels<T_SrcColor> == 3 && T_SrcColor::template has_channel<R> &&
+            T_SrcColor::template has_channel<G> && T_SrcColor::template has_channel<B>)
+        {
+            return
+                T_DstColor::template channel<L>.size <= 4 &&
+                T_SrcColor::template channel<R>.size <= 8 &&
+                T_SrcColor::template channel<G>.size <= 8 &&
+                T_SrcColor::template channel<B>.size <= 8;
+        }
+        else
+        {
+            return false;
+        }
+    }();
+
+    template <ColorType T_SrcColor>
+    inline constexpr std::size_t convert_channel_lut_bytes =
+        sizeof(luminance_channel_lut<T_SrcColor::template channel<R>.size, 299>) +
+        sizeof(luminance_channel_lut<T_SrcColor::template channel<G>.size, 587>) +
+        sizeof(luminance_channel_lut<T_SrcColor::template channel<B>.size, 114>);
+
+    enum class ConvertStrategy : std::uint8_t
+    {
+        custom,
+        lut,
+        /// per channel partial sums, see luminance_channel_lut.
+        channel_lut,
+        arithmetic,
+    };
+
+    /// how convert<T_DstColor, T_SrcColor> is done, decided at compile time.
+    /// sources of up to 8 bits always get a table. rgb to luminance takes the
+    /// partial sum tables where they fit, a few hundred bytes for the same result
+    /// as a full table. other wider sources get a table when it fits the platform
+    /// budget and a lookup is cheaper than the arithmetic.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr ConvertStrategy convert_strategy = [](){
+        if constexpr (convert_custom<T_DstColor, T_SrcColor>::value)
+        {
+            return ConvertStrategy::custom;
+        }
+        else if constexpr (std::same_as<T_DstColor, T_SrcColor>)
+        {
+            return ConvertStrategy::arithmetic;
+        }
+        else if constexpr (T_SrcColor::num_bits <= 8)
+        {
+            return ConvertStrategy::lut;
+        }
+        else if constexpr (convert_channel_lut_fits<T_DstColor, T_SrcColor>)
+        {
+            return ConvertStrategy::channel_lut;
+        }
+        else if constexpr (
+            (convert_lut_bytes<T_DstColor, T_SrcColor> <= convert_cost_model.max_lut_bytes &&
+             convert_lut_cycles<T_DstColor, T_SrcColor> < convert_arithmetic_cycles<T_DstColor, T_SrcColor>))
+        {
+            return ConvertStrategy::lut;
+        }
+        else
+        {
+            return ConvertStrategy::arithmetic;
+        }
+    }();
+
+    /// conversion table, generated at compile time into read only memory.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    requires(convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::lut)
+    inline constexpr ConvertLut<T_DstColor, T_SrcColor> convert_lut = [](){
+        ConvertLut<T_DstColor, T_SrcColor> lut{};
+        for (std::size_t i = 0; i < lut.size(); ++i)
+        {
+            lut[i] = convert<T_DstColor, T_SrcColor, BypassCustom>(
+                T_SrcColor::fromValue(static_cast<typename T_SrcColor::Value>(i)));
+        }
+        return lut;
+    }();
+
+    /// convert from RGB(A) to L(A) by summing the channel contributions from
+    /// luminance_channel_lut, identical to the arithmetic conversion.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    requires(convert_channel_lut_fits<T_DstColor, T_SrcColor>)
+    inline constexpr T_DstColor convertChannelLut(T_SrcColor p_src)
+    {
+        const auto sum =
+            luminance_channel_lut<T_SrcColor::template channel<R>.size, 299>[p_src.template get<R>()] +
+            luminance_channel_lut<T_SrcColor::template channel<G>.size, 587>[p_src.template get<G>()] +
+            luminance_channel_lut<T_SrcColor::template channel<B>.size, 114>[p_src.template get<B>()];
+
+        // floor(floor(sum / 1000) / 2^n) == floor(floor(sum / 2^n) / 1000)
+        const auto l_value = static_cast<typename T_DstColor::Value>(
+            divideBy1000(sum >> (8 - T_DstColor::template channel<L>.size)));
+
+        return [&]<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>) -> T_DstColor
+        {
+            return {
+                [&]() -> typename T_DstColor::Value {
+                    if constexpr (ChannelOfType<L, decltype(t_channels)>)
+                    {
+                        return l_value;
+                    }
+                    else if constexpr (T_SrcColor::template has_channel<A>)
+                    {
+                        return utils::resizeBits<
+                            T_DstColor::template channel<A>.size,
+                            T_SrcColor::template channel<A>.size
+                        >(static_cast<T_DstColor::Value>(p_src.template get<A>()));
+                    }
+                    else
+                    {
+                        return utils::bits<t_channels.size>;
+                    }
+                }()
+                ...,
+            };
+        }(T_DstColor{});
+    }
+
     /// convert between colors.
     template <ColorType T_DstColor, ColorType T_SrcColor>
     inline constexpr T_DstColor convert(T_SrcColor p_src)
     {
-        if constexpr (convert_custom<T_DstColor, T_SrcColor>::value)
+        if constexpr (convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::custom)
         {
             return convert_custom<T_DstColor, T_SrcColor>::operator()(p_src);
         }
+        else if constexpr (convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::lut)
+        {
+            return convert_lut<T_DstColor, T_SrcColor>[p_src.value & utils::bits<T_SrcColor::num_bits>];
+        }
+        else if constexpr (convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::channel_lut)
+        {
+            return convertChannelLut<T_DstColor>(p_src);
+        }
         else
         {
             return convert<T_DstColor, T_SrcColor, BypassCustom>(p_src);
         }
     }
 
+    static_assert(convert_strategy<GS4, GS4> == ConvertStrategy::arithmetic);
+    static_assert(convert_strategy<GS4, GS4A1> == ConvertStrategy::lut);
+    static_assert(convert_strategy<R5G6B5, GS4A1> == ConvertStrategy::lut);
+    static_assert(convert_strategy<GS4, R5G6B5> == ConvertStrategy::channel_lut);
+    static_assert(convert_strategy<GS4A1, R5G5B5A1> == ConvertStrategy::channel_lut);
+    static_assert(convert_channel_lut_bytes<R5G6B5> == (32 + 64 + 32) * 4);
+    static_assert(convert_strategy<GS4, R8G8B8> == ConvertStrategy::channel_lut);
+    static_assert(convert_strategy<R5G6B5, R5G5B5A1> == ConvertStrategy::arithmetic);
+
+    
+    /// convert between palette indices.
+    /// indices are zero extended or truncated, never rescaled.
+    template<ColorType T_DstColor, ColorType T_SrcColor, BypassCustomType>
+    requires(
+        num_color_channels<T_DstColor> == 1 &&
+        T_DstColor::template has_channel<I> &&
+        num_color_channels<T_SrcColor> == 1 &&
+        T_SrcColor::template has_channel<I>
+    )
+    inline constexpr T_DstColor convert(T_SrcColor p_src)
+    {
+        return T_DstColor{ static_cast<typename T_DstColor::Value>(p_src.template get<I>()) };
+    }
+
+    static_assert(convert<I8, I4, BypassCustom>({9}).get<I>() == 9);
+    static_assert(convert<I4, I8, BypassCustom>({0x1A}).get<I>() == 0xA);
+
     
     /// convert between colors with the same set of color channels.
     template<ColorType T_DstColor, ColorType T_SrcColor, BypassCustomType>
-    requires(same_set_color_channels<T_DstColor, T_SrcColor>)
+    requires(
+        same_set_color_channels<T_DstColor, T_SrcColor> &&
+        !T_DstColor::template has_channel<I>
+    )
     inline constexpr T_DstColor convert(T_SrcColor p_src)
     {
         if constexpr (T_DstColor::template has_channel<A> && !T_SrcColor::template has_channel<A>)
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "color.hpp"
+#include "convert.hpp"
+
+#include "time/time.hpp"
+#include "utils/benchmark.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+namespace picon::graphics::color
+{
+
+    constexpr const char* getName(ConvertStrategy p_strategy)
+    {
+        switch (p_strategy)
+        {
+        case ConvertStrategy::custom: return "custom";
+        case ConvertStrategy::lut: return "lut";
+        case ConvertStrategy::channel_lut: return "channel_lut";
+        case ConvertStrategy::arithmetic: return "arithmetic";
+        }
+        return "";
+    }
+
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    constexpr std::size_t getTableBytes()
+    {
+        if constexpr (convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::lut)
+        {
+            return convert_lut_bytes<T_DstColor, T_SrcColor>;
+        }
+        else if constexpr (convert_strategy<T_DstColor, T_SrcColor> == ConvertStrategy::channel_lut)
+        {
+            return convert_channel_lut_bytes<T_SrcColor>;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /// print the strategy of convert<T_DstColor, T_SrcColor> and its measured speed,
+    /// converting source values in order so tables are walked like a gradient.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    void benchmarkConvert(const char* p_name, std::size_t p_num_pixels = 1 << 18)
+    {
+        constexpr std::size_t num_values = T_SrcColor::num_bits < 16 ? std::size_t{1} << T_SrcColor::num_bits : 1 << 16;
+
+        typename T_DstColor::Value accumulator{};
+
+        const auto start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_pixels; ++i)
+        {
+            const auto src = T_SrcColor::fromValue(static_cast<typename T_SrcColor::Value>(i % num_values));
+            accumulator ^= convert<T_DstColor, T_SrcColor>(src).value;
+        }
+        utils::doNotOptimize(accumulator);
+        const auto elapsed_us = time::getEpochTimeUs64() - start;
+
+        std::printf("%-24s %-10s %8zu B %10.2f Mpx/s\n",
+            p_name,
+            getName(convert_strategy<T_DstColor, T_SrcColor>),
+            getTableBytes<T_DstColor, T_SrcColor>(),
+            elapsed_us > 0 ? static_cast<double>(p_num_pixels) / elapsed_us : 0.0);
+    }
+
+    /// compare the partial sum tables of convert<GS4, T_SrcColor> against a full
+    /// table built at startup, printing the build time, both speeds and whether
+    /// every source value converts the same.
+    template <ColorType T_SrcColor>
+    requires(convert_strategy<GS4, T_SrcColor> == ConvertStrategy::channel_lut)
+    void benchmarkChannelLut(const char* p_name, std::size_t p_num_pixels = 1 << 18)
+    {
+        constexpr std::size_t num_values = utils::bits<T_SrcColor::num_bits> + 1;
+
+        auto build_start = time::getEpochTimeUs64();
+        auto full = std::make_unique<ConvertLut<GS4, T_SrcColor>>();
+        for (std::size_t i = 0; i < num_values; ++i)
+        {
+            (*full)[i] = convert<GS4, T_SrcColor, BypassCustom>(T_SrcColor::fromValue(static_cast<typename T_SrcColor::Value>(i)));
+        }
+        const auto build_us = time::getEpochTimeUs64() - build_start;
+
+        std::size_t num_mismatches{};
+        for (std::size_t i = 0; i < num_values; ++i)
+        {
+            const auto src = T_SrcColor::fromValue(static_cast<typename T_SrcColor::Value>(i));
+            num_mismatches += convert<GS4, T_SrcColor>(src).value != (*full)[i].value;
+        }
+
+        GS4::Value accumulator{};
+
+        const auto full_start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_pixels; ++i)
+        {
+            accumulator ^= (*full)[i % num_values].value;
+        }
+        utils::doNotOptimize(accumulator);
+        const auto full_us = time::getEpochTimeUs64() - full_start;
+
+        const auto channel_start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_pixels; ++i)
+        {
+            accumulator ^= convert<GS4, T_SrcColor>(T_SrcColor::fromValue(static_cast<typename T_SrcColor::Value>(i % num_values))).value;
+        }
+        utils::doNotOptimize(accumulator);
+        const auto channel_us = time::getEpochTimeUs64() - channel_start;
+
+        std::printf("%-24s full %zu B built in %llu us %.2f Mpx/s, channel_lut %zu B %.2f Mpx/s, %zu mismatches\n",
+            p_name,
+            sizeof(ConvertLut<GS4, T_SrcColor>),
+            static_cast<unsigned long long>(build_us),
+            full_us > 0 ? static_cast<double>(p_num_pixels) / full_us : 0.0,
+            convert_channel_lut_bytes<T_SrcColor>,
+            channel_us > 0 ? static_cast<double>(p_num_pixels) / channel_us : 0.0,
+            num_mismatches);
+    }
+
+    /// the conversions the renderer uses between its framebuffer and asset formats.
+    inline void benchmarkConverts()
+    {
+        std::printf("%-24s %-10s %10s %16s\n", "dst <- src", "strategy", "table", "speed");
+        benchmarkConvert<GS4, GS4A1>("GS4 <- GS4A1");
+        benchmarkConvert<GS4, R5G6B5>("GS4 <- R5G6B5");
+        benchmarkConvert<GS4, R5G5B5A1>("GS4 <- R5G5B5A1");
+        benchmarkConvert<GS4, R4G4B4A4>("GS4 <- R4G4B4A4");
+        benchmarkConvert<GS4, R8G8B8>("GS4 <- R8G8B8");
+        benchmarkConvert<GS4A1, R5G5B5A1>("GS4A1 <- R5G5B5A1");
+        benchmarkConvert<R5G6B5, GS4>("R5G6B5 <- GS4");
+        benchmarkConvert<R5G6B5, R5G5B5A1>("R5G6B5 <- R5G5B5A1");
+        benchmarkConvert<R4G4B4A4, GS4A1>("R4G4B4A4 <- GS4A1");
+        benchmarkConvert<R4G4B4A4, R5G5B5A1>("R4G4B4A4 <- R5G5B5A1");
+        benchmarkConvert<R8G8B8, R5G6B5>("R8G8B8 <- R5G6B5");
+
+        benchmarkChannelLut<R5G6B5>("GS4 <- R5G6B5");
+        benchmarkChannelLut<R5G5B5A1>("GS4 <- R5G5B5A1");
+        benchmarkChannelLut<R4G4B4A4>("GS4 <- R4G4B4A4");
+    }
+
+} // namespace picon::graphics::color
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "convert.hpp"
+
+#include "utils/bit_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace picon::graphics::color
+{
+    /// 4x4 bayer threshold matrix, row major.
+    inline constexpr std::array<std::uint8_t, 16> bayer_4x4{
+        0,  8,  2,  10,
+        12, 4,  14, 6,
+        3,  11, 1,  9,
+        15, 7,  13, 5,
+    };
+
+    /// ordered dither table quantizing an 8 bit channel to t_dst_bits.
+    /// indexed by [(y % 4) * 4 + (x % 4)][value].
+    /// @tparam t_dst_bits
+    template <std::size_t t_dst_bits>
+    requires(t_dst_bits < 8)
+    inline constexpr auto ordered_dither_lut = []()
+    {
+        std::array<std::array<std::uint8_t, 256>, bayer_4x4.size()> lut{};
+        for (std::size_t pos = 0; pos < bayer_4x4.size(); ++pos)
+        {
+            // thresholds centered in each of the 16 bands of [0, 255).
+            const std::size_t threshold = (bayer_4x4[pos] * 2 + 1) * 255 / 32;
+            for (std::size_t value = 0; value < lut[pos].size(); ++value)
+            {
+                lut[pos][value] = (value * utils::bits<t_dst_bits> + threshold) / 255;
+            }
+        }
+        return lut;
+    }();
+
+    static_assert(ordered_dither_lut<4>[0][0] == 0);
+    static_assert(ordered_dither_lut<4>[15][0] == 0);
+    static_assert(ordered_dither_lut<4>[0][255] == 15);
+    static_assert(ordered_dither_lut<4>[15][255] == 15);
+    static_assert(ordered_dither_lut<4>[0][17 * 7] == 7);
+    static_assert(ordered_dither_lut<4>[15][17 * 7] == 7);
+    static_assert(ordered_dither_lut<4>[0][17 * 7 + 8] == 7);
+    static_assert(ordered_dither_lut<4>[12][17 * 7 + 8] == 8);
+
+
+    namespace internal
+    {
+        template <typename T_Color>
+        struct wide_color;
+
+        template <typename T_Value, auto... t_channels>
+        struct wide_color<Color<T_Value, t_channels...>>
+        {
+            using type = Color<std::uint64_t, decltype(t_channels){std::max<std::size_t>(t_channels.size, 8)}...>;
+        };
+    } // namespace internal
+
+    /// T_Color with every channel widened to at least 8 bits.
+    /// intermediate format for dithered conversion.
+    template <ColorType T_Color>
+    using WideColor = typename internal::wide_color<T_Color>::type;
+
+    static_assert(WideColor<GS4>::channel<L>.size == 8);
+    static_assert(WideColor<R5G5B5A1>::channel<G>.size == 8);
+    static_assert(WideColor<R5G5B5A1>::channel<A>.size == 8);
+
+
+    /// convert with 4x4 ordered dithering at destination pixel p_x, p_y.
+    /// color channels under 8 bits are dithered via ordered_dither_lut, alpha is truncated.
+    template <ColorType T_DstColor, ColorType T_SrcColor>
+    inline constexpr T_DstColor convertDithered(T_SrcColor p_src, std::size_t p_x, std::size_t p_y)
+    {
+        using Wide = WideColor<T_DstColor>;
+        const auto wide = convert<Wide, T_SrcColor>(p_src);
+        const auto pos = (p_y % 4) * 4 + (p_x % 4);
+
+        return [&]<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>) -> T_DstColor
+        {
+            return {
+                [&]() -> typename T_DstColor::Value
+                {
+                    constexpr auto dst_size = T_DstColor::template channel<decltype(t_channels)>.size;
+                    constexpr auto wide_size = Wide::template channel<decltype(t_channels)>.size;
+                    const auto value = wide.template get<decltype(t_channels)>();
+
+                    if constexpr (ChannelOfType<A, decltype(t_channels)> || dst_size >= 8)
+                    {
+                        return utils::resizeBits<dst_size, wide_size>(value);
+                    }
+                    else
+                    {
+                        return ordered_dither_lut<dst_size>[pos][value];
+                    }
+                }()
+                ...,
+            };
+        }(T_DstColor{});
+    }
+
+    // flat mid gray dithers between the two nearest levels.
+    static_assert(convertDithered<GS4>(R8G8B8{127, 127, 127}, 0, 0).get<L>() == 7);
+    static_assert(convertDithered<GS4>(R8G8B8{127, 127, 127}, 0, 3).get<L>() == 8);
+    static_assert(convertDithered<GS4>(R8G8B8{0, 0, 0}, 3, 3).get<L>() == 0);
+    static_assert(convertDithered<GS4>(R8G8B8{255, 255, 255}, 3, 3).get<L>() == 15);
+    static_assert(convertDithered<GS4A1>(R5G5B5A1{31, 31, 31, 0}, 1, 1).get<A>() == 0);
+    static_assert(convertDithered<R5G6B5>(R8G8B8{255, 0, 255}, 1, 2).get<G>() == 0);
+
+
+    namespace blend
+    {
+        /// overwrite with 4x4 ordered dithering.
+        constexpr struct OrderedDither
+        {
+            template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
+            static constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src, std::size_t p_x, std::size_t p_y)
+            {
+                r_dst = convertDithered<T_DstFormat, T_SrcFormat>(p_src, p_x, p_y);
+            }
+        } ordered_dither;
+
+        template <> inline constexpr bool replaces_opaque<OrderedDither> = true;
+        template <> inline constexpr bool replaces_always<OrderedDither> = true;
+
+
+        /// 1 bit alpha test with 4x4 ordered dithering.
+        constexpr struct OrderedDitherAlpha
+        {
+            template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
+            requires(!T_SrcFormat::template has_channel<A>)
+            static constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src, std::size_t p_x, std::size_t p_y)
+            {
+                OrderedDither::operator()(r_dst, p_src, p_x, p_y);
+            }
+
+            template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
+            requires(T_SrcFormat::template channel<A>.size == 1)
+            static constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src, std::size_t p_x, std::size_t p_y)
+            {
+                if (p_src.template get<A>() > 0) { r_dst = convertDithered<T_DstFormat, T_SrcFormat>(p_src, p_x, p_y); }
+            }
+        } ordered_dither_alpha;
+
+        template <> inline constexpr bool replaces_opaque<OrderedDitherAlpha> = true;
+
+    } // namespace blend
+
+} // namespace picon::graphics::color
\ No newline at end of file
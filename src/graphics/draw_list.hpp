@@ -0,0 +1,331 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+
+#include "utils/bit_utils.hpp"
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace picon::graphics
+{
+
+    /// pixels submitted to and written by a DrawList, for measuring overdraw.
+    struct DrawListStats
+    {
+        std::size_t num_draws{};
+        /// draws hidden entirely by an opaque draw in front of them.
+        std::size_t num_culled{};
+        std::size_t submitted_pixels{};
+        std::size_t drawn_pixels{};
+    };
+
+
+    /// a recorded draw, clipped to the destination.
+    /// span draws the pixels of row p_y from p_x to p_x + p_w, which lie inside the draw.
+    template <color::ColorType T_Format>
+    struct Draw
+    {
+        using SpanFn = void (*)(const Draw& p_draw, Image<T_Format> p_dst, std::size_t p_x, std::size_t p_y, std::size_t p_w);
+
+        SpanFn span{};
+        /// source image pixels, or nullptr for fills.
+        const void* source{};
+        /// fill color value.
+        std::uint32_t value{};
+
+        std::uint16_t x{};
+        std::uint16_t y{};
+        std::uint16_t w{};
+        std::uint16_t h{};
+
+        std::uint16_t src_x{};
+        std::uint16_t src_y{};
+        std::uint16_t src_width{};
+        std::uint16_t src_height{};
+
+        /// every pixel overwrites what is beneath it.
+        bool opaque{};
+
+        constexpr bool overlaps(const Draw& p_other) const
+        {
+            return
+                x < p_other.x + p_other.w && p_other.x < x + w &&
+                y < p_other.y + p_other.h && p_other.y < y + h;
+        }
+
+        constexpr bool contains(const Draw& p_other) const
+        {
+            return
+                x <= p_other.x && p_other.x + p_other.w <= x + w &&
+                y <= p_other.y && p_other.y + p_other.h <= y + h;
+        }
+    };
+
+
+    namespace internal
+    {
+        template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat, typename T_Blend>
+        void fillDrawSpan(const Draw<T_DstFormat>& p_draw, Image<T_DstFormat> p_dst, std::size_t p_x, std::size_t p_y, std::size_t p_w)
+        {
+            const auto value = T_SrcFormat::fromValue(static_cast<typename T_SrcFormat::Value>(p_draw.value));
+            fn::internal::fillSpanUnclipped(p_dst, p_x, p_y, p_w, value, T_Blend{});
+        }
+
+        template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat, typename T_Blend>
+        void blitDrawSpan(const Draw<T_DstFormat>& p_draw, Image<T_DstFormat> p_dst, std::size_t p_x, std::size_t p_y, std::size_t p_w)
+        {
+            const Image<T_SrcFormat> src{
+                p_draw.src_width,
+                p_draw.src_height,
+                static_cast<T_SrcFormat*>(const_cast<void*>(p_draw.source))
+            };
+            fn::internal::blitUnclipped(
+                p_dst, p_x, p_y,
+                src, p_draw.src_x + (p_x - p_draw.x), p_draw.src_y + (p_y - p_draw.y), p_w, 1,
+                T_Blend{});
+        }
+    } // namespace internal
+
+
+    /// records a frame's draws and renders them with overdraw removed.
+    /// draws are submitted back to front as with immediate drawing. on flush,
+    /// each draw is trimmed to the spans not covered by opaque draws submitted
+    /// after it, so pixels hidden by e.g. an opaque background are never written,
+    /// and a clear beneath a full screen background costs nothing.
+    /// draws that overflow the list flush it first, which stays correct but
+    /// can't trim against draws that come later.
+    /// draws are clipped when recorded, so a ClipStack on dst applies to the
+    /// draws recorded while it is pushed.
+    /// sources must stay alive until the flush.
+    /// @tparam T_Format destination format
+    /// @tparam t_capacity max draws per flush
+    /// @tparam t_max_occluders max opaque draws a draw is trimmed against, more are drawn over
+    template <color::ColorType T_Format, std::size_t t_capacity, std::size_t t_max_occluders = 16>
+    requires(t_capacity <= UINT16_MAX)
+    struct DrawList
+    {
+        using Format = T_Format;
+
+        constexpr static auto capacity = t_capacity;
+        constexpr static auto max_occluders = t_max_occluders;
+
+        Image<T_Format> dst{0, 0, nullptr};
+
+        std::array<Draw<T_Format>, t_capacity> draws{};
+        std::size_t num_draws{};
+
+        /// indices of the opaque draws, ascending.
+        std::array<std::uint16_t, t_capacity> occluders{};
+        std::size_t num_occluders{};
+
+        DrawListStats stats{};
+
+        /// start recording draws into p_dst, resetting the stats.
+        void begin(Image<T_Format> p_dst)
+        {
+            dst = p_dst;
+            num_draws = 0;
+            num_occluders = 0;
+            stats = {};
+        }
+
+        /// fill the destination's scissor.
+        template <
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_Format, T_SrcFormat> T_Blend=color::blend::None
+        >
+        void fill(T_SrcFormat p_value, T_Blend p_blend = {})
+        {
+            fillRect(dst.scissor.position.x, dst.scissor.position.y, dst.scissor.size.x, dst.scissor.size.y, p_value, p_blend);
+        }
+
+        /// fill rect, clipped to the destination's scissor.
+        template <
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_Format, T_SrcFormat> T_Blend=color::blend::None
+        >
+        requires(sizeof(typename T_SrcFormat::Value) <= sizeof(std::uint32_t) && std::is_empty_v<T_Blend>)
+        void fillRect(
+            utils::isize_t p_x, utils::isize_t p_y,
+            utils::isize_t p_w, utils::isize_t p_h,
+            T_SrcFormat p_value,
+            T_Blend = {}
+        )
+        {
+            const auto clip = dst.scissor.intersect({{p_x, p_y}, {p_w, p_h}});
+            if (!clip || clip->empty()) { return; }
+
+            const auto opaque = [&](){
+                if constexpr (color::blend::replaces_always<T_Blend>) { return true; }
+                else if constexpr (!color::blend::replaces_opaque<T_Blend>) { return false; }
+                else if constexpr (!T_SrcFormat::template has_channel<color::A>) { return true; }
+                else
+                {
+                    return p_value.template get<color::A>() == utils::bits<T_SrcFormat::template channel<color::A>.size>;
+                }
+            }();
+
+            push({
+                .span = internal::fillDrawSpan<T_Format, T_SrcFormat, T_Blend>,
+                .value = static_cast<std::uint32_t>(p_value.value),
+                .x = static_cast<std::uint16_t>(clip->position.x),
+                .y = static_cast<std::uint16_t>(clip->position.y),
+                .w = static_cast<std::uint16_t>(clip->size.x),
+                .h = static_cast<std::uint16_t>(clip->size.y),
+                .opaque = opaque,
+            });
+        }
+
+        /// full src blit, clipped to the destination's scissor.
+        /// p_opaque tells that every pixel of p_src has full alpha, as the importer
+        /// records in <name>_opaque. sources without alpha always are.
+        template <
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_Format, T_SrcFormat> T_Blend=color::blend::None
+        >
+        requires(std::is_empty_v<T_Blend>)
+        void blit(
+            utils::isize_t p_x, utils::isize_t p_y,
+            const Image<T_SrcFormat> p_src,
+            T_Blend = {},
+            bool p_opaque = !T_SrcFormat::template has_channel<color::A>
+        )
+        {
+            utils::isize_t src_x = 0;
+            utils::isize_t src_y = 0;
+            utils::isize_t src_w = p_src.width;
+            utils::isize_t src_h = p_src.height;
+            if (!fn::blitSafeSize(dst, p_x, p_y, p_src, src_x, src_y, src_w, src_h) || src_w <= 0 || src_h <= 0)
+            {
+                return;
+            }
+
+            push({
+                .span = internal::blitDrawSpan<T_Format, T_SrcFormat, T_Blend>,
+                .source = p_src.data(),
+                .x = static_cast<std::uint16_t>(p_x),
+                .y = static_cast<std::uint16_t>(p_y),
+                .w = static_cast<std::uint16_t>(src_w),
+                .h = static_cast<std::uint16_t>(src_h),
+                .src_x = static_cast<std::uint16_t>(src_x),
+                .src_y = static_cast<std::uint16_t>(src_y),
+                .src_width = static_cast<std::uint16_t>(p_src.width),
+                .src_height = static_cast<std::uint16_t>(p_src.height),
+                .opaque = color::blend::replaces_always<T_Blend> || (color::blend::replaces_opaque<T_Blend> && p_opaque),
+            });
+        }
+
+        /// render and clear the recorded draws, back to front.
+        void flush()
+        {
+            for (std::size_t i = 0; i < num_draws; ++i)
+            {
+                drawVisible(i);
+            }
+            num_draws = 0;
+            num_occluders = 0;
+        }
+
+        const DrawListStats& getStats() const
+        {
+            return stats;
+        }
+
+    private:
+        struct Span
+        {
+            std::uint16_t x0;
+            std::uint16_t x1;
+        };
+
+        void push(const Draw<T_Format>& p_draw)
+        {
+            if (num_draws == t_capacity)
+            {
+                flush();
+            }
+
+            if (p_draw.opaque)
+            {
+                occluders[num_occluders++] = static_cast<std::uint16_t>(num_draws);
+            }
+            draws[num_draws++] = p_draw;
+
+            ++stats.num_draws;
+            stats.submitted_pixels += std::size_t{p_draw.w} * p_draw.h;
+        }
+
+        /// draw the spans of draw p_index not hidden by opaque draws in front of it.
+        void drawVisible(std::size_t p_index)
+        {
+            const auto& draw = draws[p_index];
+
+            std::array<std::uint16_t, t_max_occluders> candidates;
+            std::size_t num_candidates = 0;
+            for (auto k = num_occluders; k-- > 0 && occluders[k] > p_index;)
+            {
+                const auto& occluder = draws[occluders[k]];
+                if (!occluder.overlaps(draw)) { continue; }
+                if (occluder.contains(draw))
+                {
+                    ++stats.num_culled;
+                    return;
+                }
+                if (num_candidates < t_max_occluders)
+                {
+                    candidates[num_candidates++] = occluders[k];
+                }
+            }
+
+            const std::size_t x_end = draw.x + draw.w;
+            for (std::size_t y = draw.y; y < std::size_t{draw.y} + draw.h; ++y)
+            {
+                // covered spans of this row, sorted by start.
+                std::array<Span, t_max_occluders> spans;
+                std::size_t num_spans = 0;
+                for (std::size_t c = 0; c < num_candidates; ++c)
+                {
+                    const auto& occluder = draws[candidates[c]];
+                    if (y < occluder.y || y >= std::size_t{occluder.y} + occluder.h) { continue; }
+
+                    const Span span{occluder.x, static_cast<std::uint16_t>(occluder.x + occluder.w)};
+                    auto i = num_spans++;
+                    for (; i > 0 && spans[i - 1].x0 > span.x0; --i)
+                    {
+                        spans[i] = spans[i - 1];
+                    }
+                    spans[i] = span;
+                }
+
+                std::size_t x = draw.x;
+                for (std::size_t s = 0; s < num_spans && x < x_end; ++s)
+                {
+                    if (spans[s].x0 > x)
+                    {
+                        drawSpan(draw, x, y, std::min<std::size_t>(spans[s].x0, x_end) - x);
+                    }
+                    x = std::max<std::size_t>(x, spans[s].x1);
+                }
+                if (x < x_end)
+                {
+                    drawSpan(draw, x, y, x_end - x);
+                }
+            }
+        }
+
+        void drawSpan(const Draw<T_Format>& p_draw, std::size_t p_x, std::size_t p_y, std::size_t p_w)
+        {
+            p_draw.span(p_draw, dst, p_x, p_y, p_w);
+            stats.drawn_pixels += p_w;
+        }
+    };
+
+} // namespace picon::graphics
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace picon::graphics
+{
+
+    /// placement of one glyph in a font atlas, and its metrics.
+    struct Glyph
+    {
+        /// top left of the glyph mask in the atlas, in pixels.
+        std::uint16_t x{};
+        std::uint16_t y{};
+
+        /// size of the glyph mask, in pixels.
+        std::uint8_t width{};
+        std::uint8_t height{};
+
+        /// offset from the pen position to the top left of the mask.
+        /// y is relative to the top of the line.
+        std::int8_t offset_x{};
+        std::int8_t offset_y{};
+
+        /// pen advance after this glyph.
+        std::uint8_t advance{};
+    };
+
+
+    /// bitmap font backed by a single 1-bit glyph atlas.
+    /// atlas rows are packed MSB first, atlas_stride bytes per row.
+    /// glyphs cover the contiguous codepoint range starting at first_codepoint.
+    struct Font
+    {
+        std::size_t atlas_stride{};
+        std::span<const std::uint8_t> atlas{};
+        std::span<const Glyph> glyphs{};
+        char32_t first_codepoint{};
+        std::uint8_t line_height{};
+        std::uint8_t ascent{};
+
+        /// glyph for codepoint, or nullptr if the font doesn't cover it.
+        constexpr const Glyph* glyph(char32_t p_codepoint) const
+        {
+            if (p_codepoint < first_codepoint) { return nullptr; }
+            const std::size_t index = p_codepoint - first_codepoint;
+            if (index >= glyphs.size()) { return nullptr; }
+            return &glyphs[index];
+        }
+
+        /// whether the mask bit at p_x, p_y of p_glyph is set.
+        constexpr bool bit(const Glyph& p_glyph, std::size_t p_x, std::size_t p_y) const
+        {
+            const std::size_t x = p_glyph.x + p_x;
+            const std::size_t y = p_glyph.y + p_y;
+            return (atlas[y * atlas_stride + x / CHAR_BIT] >> (CHAR_BIT - 1 - x % CHAR_BIT)) & 1;
+        }
+    };
+
+} // namespace picon::graphics
\ No newline at end of file
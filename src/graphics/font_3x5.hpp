@@ -0,0 +1,127 @@
+#pragma once
+
+#include "font.hpp"
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+namespace picon::graphics::fonts
+{
+
+    namespace internal
+    {
+        /// ' ' to 'Z', 5 rows of 3 bits each, top row in the high bits.
+        inline constexpr std::array<std::uint16_t, 'Z' - ' ' + 1> glyphs_3x5{
+            0b000'000'000'000'000, // ' '
+            0b010'010'010'000'010, // !
+            0b101'101'000'000'000, // "
+            0b101'111'101'111'101, // #
+            0b011'110'010'011'110, // $
+            0b101'001'010'100'101, // %
+            0b010'101'010'101'011, // &
+            0b010'010'000'000'000, // '
+            0b001'010'010'010'001, // (
+            0b100'010'010'010'100, // )
+            0b000'101'010'101'000, // *
+            0b000'010'111'010'000, // +
+            0b000'000'000'010'100, // ,
+            0b000'000'111'000'000, // -
+            0b000'000'000'000'010, // .
+            0b001'001'010'100'100, // /
+            0b111'101'101'101'111, // 0
+            0b010'110'010'010'111, // 1
+            0b111'001'111'100'111, // 2
+            0b111'001'111'001'111, // 3
+            0b101'101'111'001'001, // 4
+            0b111'100'111'001'111, // 5
+            0b111'100'111'101'111, // 6
+            0b111'001'001'010'010, // 7
+            0b111'101'111'101'111, // 8
+            0b111'101'111'001'111, // 9
+            0b000'010'000'010'000, // :
+            0b000'010'000'010'100, // ;
+            0b001'010'100'010'001, // <
+            0b000'111'000'111'000, // =
+            0b100'010'001'010'100, // >
+            0b111'001'010'000'010, // ?
+            0b010'101'111'100'011, // @
+            0b010'101'111'101'101, // A
+            0b110'101'110'101'110, // B
+            0b011'100'100'100'011, // C
+            0b110'101'101'101'110, // D
+            0b111'100'110'100'111, // E
+            0b111'100'110'100'100, // F
+            0b011'100'101'101'011, // G
+            0b101'101'111'101'101, // H
+            0b111'010'010'010'111, // I
+            0b001'001'001'101'010, // J
+            0b101'101'110'101'101, // K
+            0b100'100'100'100'111, // L
+            0b101'111'101'101'101, // M
+            0b110'101'101'101'101, // N
+            0b010'101'101'101'010, // O
+            0b110'101'110'100'100, // P
+            0b010'101'101'111'011, // Q
+            0b110'101'110'101'101, // R
+            0b011'100'010'001'110, // S
+            0b111'010'010'010'010, // T
+            0b101'101'101'101'111, // U
+            0b101'101'101'101'010, // V
+            0b101'101'111'111'101, // W
+            0b101'101'010'101'101, // X
+            0b101'101'010'010'010, // Y
+            0b111'001'010'100'111, // Z
+        };
+
+        inline constexpr std::size_t atlas_3x5_stride = (glyphs_3x5.size() * 3 + CHAR_BIT - 1) / CHAR_BIT;
+
+        /// the glyphs side by side in one 5 pixel high strip.
+        inline constexpr auto atlas_3x5 = [](){
+            std::array<std::uint8_t, atlas_3x5_stride * 5> atlas{};
+            for (std::size_t i = 0; i < glyphs_3x5.size(); ++i)
+            {
+                for (std::size_t y = 0; y < 5; ++y)
+                {
+                    for (std::size_t x = 0; x < 3; ++x)
+                    {
+                        if ((glyphs_3x5[i] >> ((4 - y) * 3 + (2 - x))) & 1)
+                        {
+                            const auto atlas_x = i * 3 + x;
+                            atlas[y * atlas_3x5_stride + atlas_x / CHAR_BIT] |= 0x80 >> (atlas_x % CHAR_BIT);
+                        }
+                    }
+                }
+            }
+            return atlas;
+        }();
+
+        inline constexpr auto glyph_table_3x5 = [](){
+            std::array<Glyph, glyphs_3x5.size()> glyphs{};
+            for (std::size_t i = 0; i < glyphs.size(); ++i)
+            {
+                glyphs[i] = {static_cast<std::uint16_t>(i * 3), 0, 3, 5, 0, 0, 4};
+            }
+            return glyphs;
+        }();
+    } // namespace internal
+
+    /// 3x5 pixel font embedded in the binary, ' ' to 'Z', upper case only.
+    /// for diagnostics that can't depend on imported assets.
+    inline constexpr Font font_3x5{
+        internal::atlas_3x5_stride,
+        internal::atlas_3x5,
+        internal::glyph_table_3x5,
+        ' ',
+        6,
+        5,
+    };
+
+    static_assert(font_3x5.glyph('Z') != nullptr);
+    static_assert(font_3x5.glyph('a') == nullptr);
+    static_assert(font_3x5.bit(*font_3x5.glyph('1'), 1, 0));
+    static_assert(!font_3x5.bit(*font_3x5.glyph('1'), 0, 0));
+    static_assert(font_3x5.bit(*font_3x5.glyph('Z'), 2, 4));
+
+} // namespace picon::graphics::fonts
@@ -4,15 +4,163 @@
 #include "color.hpp"
 #include "convert.hpp"
 #include "image.hpp"
+#include "instrument.hpp"
 
 #include "utils/types.hpp"
 
 #include <algorithm>
+#include <concepts>
+#include <type_traits>
 
 namespace picon::graphics::fn
 {
 
+    namespace internal
+    {
+        /// fill span loop, uninstrumented.
+        /// unblended fills convert once and store the whole span.
+        template <
+            color::ColorType T_DstFormat,
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+        >
+        inline void fillSpanKernel(
+            Image<T_DstFormat> p_dst,
+            std::size_t p_dst_x, std::size_t p_dst_y, std::size_t p_dst_w,
+            T_SrcFormat p_value,
+            T_Blend& p_blend
+        )
+        {
+            const auto row = p_dst.rowBegin(p_dst_y) + p_dst_x;
+            if constexpr (std::same_as<T_Blend, color::blend::None>)
+            {
+                std::fill(row, row + p_dst_w, color::convert<T_DstFormat>(p_value));
+            }
+            else
+            {
+                for (std::size_t x = 0; x < p_dst_w; ++x)
+                {
+                    color::blend::apply(p_blend, row[x], p_value, p_dst_x + x, p_dst_y);
+                }
+            }
+        }
+
+        /// fills p_dst_w pixels of row p_dst_y starting at p_dst_x, which must be inside the scissor.
+        template <
+            color::ColorType T_DstFormat,
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+        >
+        inline void fillSpanUnclipped(
+            Image<T_DstFormat> p_dst,
+            std::size_t p_dst_x, std::size_t p_dst_y, std::size_t p_dst_w,
+            T_SrcFormat p_value,
+            T_Blend p_blend = {}
+        )
+        {
+            instrument::record<instrument::Kernel::fill, T_DstFormat, T_SrcFormat, T_Blend>(p_dst, p_dst_x, p_dst_y, p_dst_w, 1);
+            fillSpanKernel(p_dst, p_dst_x, p_dst_y, p_dst_w, p_value, p_blend);
+        }
+
+        /// blit of a src rect that must land inside the scissor.
+        /// the blend mode is bound to the formats once, see color::blend::bind.
+        template <
+            color::ColorType T_DstFormat,
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+        >
+        inline void blitUnclipped(
+            Image<T_DstFormat> p_dst, std::size_t p_dst_x, std::size_t p_dst_y,
+            const Image<T_SrcFormat> p_src, std::size_t p_src_x, std::size_t p_src_y, std::size_t p_src_w, std::size_t p_src_h,
+            T_Blend p_blend={}
+        )
+        {
+            instrument::record<instrument::Kernel::blit, T_DstFormat, T_SrcFormat, T_Blend>(p_dst, p_dst_x, p_dst_y, p_src_w, p_src_h);
+
+            auto&& blend = color::blend::bind<T_DstFormat, T_SrcFormat>(p_blend);
+            for (std::size_t y = 0; y < p_src_h; ++y)
+            {
+                for (std::size_t x = 0; x < p_src_w; ++x)
+                {
+                    const auto& src_px = p_src.at(p_src_x + x, p_src_y + y);
+                    color::blend::apply(blend, p_dst.at(p_dst_x + x, p_dst_y + y), src_px, p_dst_x + x, p_dst_y + y);
+                }
+            }
+        }
+
+        /// blit of a packed src rect that must land inside the scissor.
+        /// each src byte is read once and unpacked into its pixels.
+        template <
+            color::ColorType T_DstFormat,
+            PackedFormat T_SrcFormat,
+            color::blend::BlendMode<T_DstFormat, std::remove_const_t<T_SrcFormat>> T_Blend=color::blend::None
+        >
+        inline void blitUnclipped(
+            Image<T_DstFormat> p_dst, std::size_t p_dst_x, std::size_t p_dst_y,
+            const PackedImage<T_SrcFormat> p_src, std::size_t p_src_x, std::size_t p_src_y, std::size_t p_src_w, std::size_t p_src_h,
+            T_Blend p_blend={}
+        )
+        {
+            using SrcFormat = PackedImage<T_SrcFormat>::Format;
+            constexpr auto pixels_per_byte = PackedImage<T_SrcFormat>::pixels_per_byte;
+
+            instrument::record<instrument::Kernel::blit, T_DstFormat, SrcFormat, T_Blend>(p_dst, p_dst_x, p_dst_y, p_src_w, p_src_h);
+
+            auto&& blend = color::blend::bind<T_DstFormat, SrcFormat>(p_blend);
+            for (std::size_t y = 0; y < p_src_h; ++y)
+            {
+                const auto src_row = p_src.rowBegin(p_src_y + y);
+                const auto dst_row = p_dst.rowBegin(p_dst_y + y) + p_dst_x;
+
+                std::size_t x = 0;
+                std::size_t src_x = p_src_x;
+                while (x < p_src_w)
+                {
+                    const auto byte = src_row[src_x / pixels_per_byte];
+                    for (auto i = src_x % pixels_per_byte; i < pixels_per_byte && x < p_src_w; ++i, ++x, ++src_x)
+                    {
+                        color::blend::apply(blend, dst_row[x], PackedImage<T_SrcFormat>::unpack(byte, i), p_dst_x + x, p_dst_y + y);
+                    }
+                }
+            }
+        }
+    } // namespace internal
+
+
+    /// fill rect.
+    /// clipped to the scissor once, rows are then filled unchecked.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillRect(
+        Image<T_DstFormat> p_dst,
+        std::size_t p_dst_x, std::size_t p_dst_y,
+        std::size_t p_dst_w, std::size_t p_dst_h,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        const auto clip = p_dst.scissor.intersect({
+            {static_cast<utils::isize_t>(p_dst_x), static_cast<utils::isize_t>(p_dst_y)},
+            {static_cast<utils::isize_t>(p_dst_w), static_cast<utils::isize_t>(p_dst_h)}
+        });
+        if (!clip || clip->empty()) { return; }
+
+        instrument::record<instrument::Kernel::fill, T_DstFormat, T_SrcFormat, T_Blend>(
+            p_dst, clip->position.x, clip->position.y, clip->size.x, clip->size.y);
+
+        const auto end = clip->end();
+        for (auto y = clip->position.y; y < end.y; ++y)
+        {
+            internal::fillSpanKernel(p_dst, clip->position.x, y, clip->size.x, p_value, p_blend);
+        }
+    }
+
+
     /// generic fill.
+    /// fills the scissor, the whole image unless clipped.
     template <
         color::ColorType T_DstFormat,
         color::ColorType T_SrcFormat,
@@ -20,86 +168,89 @@ namespace picon::graphics::fn
     >
     inline void fill(Image<T_DstFormat> p_dst, T_SrcFormat p_value, T_Blend p_blend = {})
     {
-        std::ranges::fill(p_dst, color::convert<T_DstFormat>(p_value));
+        if constexpr (std::same_as<T_Blend, color::blend::None>)
+        {
+            if (!p_dst.isClipped())
+            {
+                instrument::record<instrument::Kernel::fill, T_DstFormat, T_SrcFormat, T_Blend>(p_dst, 0, 0, p_dst.width, p_dst.height);
+                std::ranges::fill(p_dst, color::convert<T_DstFormat>(p_value));
+                return;
+            }
+        }
+
+        const auto& clip = p_dst.scissor;
+        fillRect(p_dst, clip.position.x, clip.position.y, clip.size.x, clip.size.y, p_value, p_blend);
     }
 
 
-    /// fill rect.
+    /// fill span.
+    /// fills p_dst_w pixels of row p_dst_y starting at p_dst_x, clipped to the scissor.
     template <
         color::ColorType T_DstFormat,
         color::ColorType T_SrcFormat,
         color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
     >
-    inline void fillRect(
+    inline void fillSpan(
         Image<T_DstFormat> p_dst,
-        std::size_t p_dst_x, std::size_t p_dst_y,
-        std::size_t p_dst_w, std::size_t p_dst_h,
+        std::size_t p_dst_x, std::size_t p_dst_y, std::size_t p_dst_w,
         T_SrcFormat p_value,
         T_Blend p_blend = {}
     )
     {
-        for (std::size_t y = 0; y < p_dst_h; ++y)
-        {
-            std::fill(
-                p_dst.rowBegin(p_dst_y + y) + p_dst_x,
-                p_dst.rowBegin(p_dst_y + y) + p_dst_x + p_dst_w,
-                color::convert<T_DstFormat>(p_value)
-            );
-        }
+        fillRect(p_dst, p_dst_x, p_dst_y, p_dst_w, 1, p_value, p_blend);
     }
     
 
     /// blit safe resize.
-    /// returns true if dst dst rect is in view
-    template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
+    /// clips the dst rect, and the src rect with it, to the scissor of p_dst.
+    /// returns false if nothing is left to draw.
+    /// p_src may be an Image or a PackedImage.
+    template <color::ColorType T_DstFormat, typename T_SrcImage>
     inline bool blitSafeSize(
         const Image<T_DstFormat> p_dst, utils::isize_t& r_dst_x, utils::isize_t& r_dst_y,
-        const Image<T_SrcFormat> p_src, utils::isize_t& r_src_x, utils::isize_t& r_src_y, utils::isize_t& r_src_w, utils::isize_t& r_src_h
+        const T_SrcImage& p_src, utils::isize_t& r_src_x, utils::isize_t& r_src_y, utils::isize_t& r_src_w, utils::isize_t& r_src_h
     )
     {
-        // completely left of image
-        if (-r_dst_x > r_src_w) { return false; }
-        // completely right of image
-        if (r_dst_x > static_cast<utils::isize_t>(p_dst.width)) { return false; }
-        // completely above of image
-        if (-r_dst_y > r_src_h) { return false; }
-        // completely below of image
-        if (r_dst_y > static_cast<utils::isize_t>(p_dst.height)) { return false; }
-        
-
-        // left of image
-        if (r_dst_x < 0)
+        const auto clip_begin = p_dst.scissor.position;
+        const auto clip_end = p_dst.scissor.end();
+
+        // trivial reject, completely left, right, above or below the scissor
+        if (r_dst_x + r_src_w <= clip_begin.x || r_dst_x >= clip_end.x) { return false; }
+        if (r_dst_y + r_src_h <= clip_begin.y || r_dst_y >= clip_end.y) { return false; }
+
+        // left of scissor
+        if (r_dst_x < clip_begin.x)
         {
-            r_src_x = -r_dst_x;
-            r_src_w = r_src_w + r_dst_x;
-            r_dst_x = 0;
+            r_src_x += clip_begin.x - r_dst_x;
+            r_src_w -= clip_begin.x - r_dst_x;
+            r_dst_x = clip_begin.x;
         }
 
-        // right of image
-        if (r_dst_x + r_src_w > static_cast<utils::isize_t>(p_dst.width))
+        // right of scissor
+        if (r_dst_x + r_src_w > clip_end.x)
         {
-            r_src_w = p_dst.width - r_dst_x;
+            r_src_w = clip_end.x - r_dst_x;
         }
 
-        // above of image
-        if (r_dst_y < 0)
+        // above scissor
+        if (r_dst_y < clip_begin.y)
         {
-            r_src_y = -r_dst_y;
-            r_src_h = r_src_h + r_dst_y;
-            r_dst_y = 0;
+            r_src_y += clip_begin.y - r_dst_y;
+            r_src_h -= clip_begin.y - r_dst_y;
+            r_dst_y = clip_begin.y;
         }
 
-        // below image
-        if (r_dst_y + r_src_h > static_cast<utils::isize_t>(p_dst.height))
+        // below scissor
+        if (r_dst_y + r_src_h > clip_end.y)
         {
-            r_src_h = p_dst.height - r_dst_y;
+            r_src_h = clip_end.y - r_dst_y;
         }
 
         return true;
     }
 
 
-    /// sized blit.
+    /// sized blit, clipped to the scissor.
     template <
         color::ColorType T_DstFormat,
         color::ColorType T_SrcFormat,
@@ -111,13 +262,15 @@ namespace picon::graphics::fn
         T_Blend p_blend={}
     )
     {
-        for (std::size_t y = 0; y < p_src_h; ++y)
+        utils::isize_t dst_x = p_dst_x;
+        utils::isize_t dst_y = p_dst_y;
+        utils::isize_t src_x = p_src_x;
+        utils::isize_t src_y = p_src_y;
+        utils::isize_t src_w = p_src_w;
+        utils::isize_t src_h = p_src_h;
+        if (blitSafeSize(p_dst, dst_x, dst_y, p_src, src_x, src_y, src_w, src_h))
         {
-            for (std::size_t x = 0; x < p_src_w; ++x)
-            {
-                const auto& src_px = p_src.at(p_src_x + x, p_src_y + y);
-                p_blend(p_dst.at(p_dst_x + x, p_dst_y + y), src_px);
-            }
+            internal::blitUnclipped(p_dst, dst_x, dst_y, p_src, src_x, src_y, src_w, src_h, p_blend);
         }
     }
 
@@ -136,7 +289,7 @@ namespace picon::graphics::fn
     {
         if (blitSafeSize(p_dst, p_dst_x, p_dst_y, p_src, p_src_x, p_src_y, p_src_w, p_src_h))
         {
-            blit(p_dst, p_dst_x, p_dst_y, p_src, p_src_x, p_src_y, p_src_w, p_src_h, p_blend);
+            internal::blitUnclipped(p_dst, p_dst_x, p_dst_y, p_src, p_src_x, p_src_y, p_src_w, p_src_h, p_blend);
         }
     }
 
@@ -172,4 +325,40 @@ namespace picon::graphics::fn
     }
 
 
+    /// packed full src blit, clipped to the scissor.
+    template <
+        color::ColorType T_DstFormat,
+        PackedFormat T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, std::remove_const_t<T_SrcFormat>> T_Blend=color::blend::None
+    >
+    inline void blitSafe(
+        Image<T_DstFormat> p_dst, utils::isize_t p_dst_x, utils::isize_t p_dst_y, const PackedImage<T_SrcFormat> p_src,
+        T_Blend p_blend={}
+    )
+    {
+        utils::isize_t src_x = 0;
+        utils::isize_t src_y = 0;
+        utils::isize_t src_w = p_src.width;
+        utils::isize_t src_h = p_src.height;
+        if (blitSafeSize(p_dst, p_dst_x, p_dst_y, p_src, src_x, src_y, src_w, src_h))
+        {
+            internal::blitUnclipped(p_dst, p_dst_x, p_dst_y, p_src, src_x, src_y, src_w, src_h, p_blend);
+        }
+    }
+
+    /// packed full src blit, clipped to the scissor.
+    template <
+        color::ColorType T_DstFormat,
+        PackedFormat T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, std::remove_const_t<T_SrcFormat>> T_Blend=color::blend::None
+    >
+    inline void blit(
+        Image<T_DstFormat> p_dst, std::size_t p_dst_x, std::size_t p_dst_y, const PackedImage<T_SrcFormat> p_src,
+        T_Blend p_blend={}
+    )
+    {
+        blitSafe(p_dst, p_dst_x, p_dst_y, p_src, p_blend);
+    }
+
+
 } // namespace picon::graphics::fn
\ No newline at end of file
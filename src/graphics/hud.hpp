@@ -0,0 +1,175 @@
+#pragma once
+
+#include "color.hpp"
+#include "font_3x5.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+#include "text.hpp"
+
+#include "time/pacer.hpp"
+#include "time/time.hpp"
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(PICON_PLATFORM_PICO)
+#include "pal/pico/pico.hpp"
+#elif defined(PICON_PLATFORM_LINUX)
+#include "pal/linux/linux.hpp"
+#endif
+
+namespace picon::graphics
+{
+
+    /// on-screen frame timing, drawn into the back buffer with the embedded 3x5 font.
+    /// durations are gathered over t_window frames and the text is laid out once
+    /// per window, so a frame only pays for the timestamps and filling the spans.
+    /// call beginFrame, endRender, draw and endTransfer in that order every frame.
+    /// @tparam t_window
+    template <std::size_t t_window = 60>
+    struct PerfHud
+    {
+        enum Stat : std::uint8_t
+        {
+            /// start of one frame to the start of the next.
+            frame,
+            /// start of the frame to endRender.
+            render,
+            /// end of draw to endTransfer.
+            transfer,
+            /// draw itself.
+            hud,
+            num_stats,
+        };
+
+        struct Window
+        {
+            std::uint32_t min{UINT32_MAX};
+            std::uint32_t max{};
+            std::uint64_t sum{};
+
+            constexpr void add(std::uint32_t p_us)
+            {
+                min = std::min(min, p_us);
+                max = std::max(max, p_us);
+                sum += p_us;
+            }
+        };
+
+        constexpr static std::array<const char*, num_stats> stat_names{"FRM", "RND", "XFR", "HUD"};
+
+        /// a header, a line per stat, the pacer's two lines and the free heap.
+        constexpr static std::size_t max_text = (num_stats + 4) * 24;
+
+        bool visible{true};
+
+        /// top left corner of the hud in the back buffer.
+        utils::isize_t x{0};
+        utils::isize_t y{0};
+
+        /// when set, its wake-up lateness and overshoot estimate are shown,
+        /// and its stats are reset with every window.
+        time::FramePacer* pacer{};
+
+        std::array<Window, num_stats> windows{};
+        /// the last full window.
+        std::array<Window, num_stats> published{};
+        std::size_t num_frames{};
+
+        std::uint64_t frame_start_us{};
+        std::uint64_t transfer_start_us{};
+
+        /// a 3 wide glyph is at most 2 runs in each of its 5 rows.
+        fn::TextLabel<max_text * 10, max_text> label{};
+
+        void beginFrame()
+        {
+            const auto now = time::getEpochTimeUs64();
+            if (frame_start_us != 0) { windows[frame].add(now - frame_start_us); }
+            frame_start_us = now;
+        }
+
+        void endRender()
+        {
+            const auto now = time::getEpochTimeUs64();
+            windows[render].add(now - frame_start_us);
+            transfer_start_us = now;
+        }
+
+        void endTransfer()
+        {
+            windows[transfer].add(time::getEpochTimeUs64() - transfer_start_us);
+
+            if (++num_frames == t_window)
+            {
+                published = windows;
+                windows = {};
+                num_frames = 0;
+                layout();
+            }
+        }
+
+        /// draw the last full window in p_color on a p_background box.
+        template <color::ColorType T_DstFormat, color::ColorType T_Color, color::ColorType T_Background>
+        void draw(Image<T_DstFormat> p_dst, T_Color p_color, T_Background p_background)
+        {
+            const auto start = time::getEpochTimeUs64();
+
+            if (visible && label.num_spans > 0)
+            {
+                fn::fillRect(
+                    p_dst,
+                    x, y,
+                    label.max_x + 3, label.max_y + 3,
+                    p_background);
+                fn::drawText(p_dst, x + 1, y + 1, label, p_color);
+            }
+
+            const auto now = time::getEpochTimeUs64();
+            windows[hud].add(now - start);
+            transfer_start_us = now;
+        }
+
+    private:
+        void layout()
+        {
+            std::array<char, max_text> text{};
+            std::size_t length = 0;
+            const auto append = [&](auto... p_args){
+                const auto written = std::snprintf(text.data() + length, text.size() - length, p_args...);
+                length = std::min(text.size() - 1, length + std::max(written, 0));
+            };
+
+            append("US   AVG   MIN   MAX");
+            for (std::size_t i = 0; i < num_stats; ++i)
+            {
+                const auto& stat = published[i];
+                append("\n%s %5lu %5lu %5lu",
+                    stat_names[i],
+                    static_cast<unsigned long>(std::min<std::uint64_t>(stat.sum / t_window, 99999)),
+                    static_cast<unsigned long>(std::min<std::uint32_t>(stat.min, 99999)),
+                    static_cast<unsigned long>(std::min<std::uint32_t>(stat.max, 99999)));
+            }
+            if (pacer != nullptr)
+            {
+                const auto& stats = pacer->getStats();
+                append("\nLAT %5lu %5lu %5lu",
+                    static_cast<unsigned long>(std::min<std::uint64_t>(stats.getMeanLateUs(), 99999)),
+                    static_cast<unsigned long>(std::min<std::uint64_t>(stats.waits > 0 ? stats.late_us_min : 0, 99999)),
+                    static_cast<unsigned long>(std::min<std::uint64_t>(stats.late_us_max, 99999)));
+                append("\nOVR %5lu", static_cast<unsigned long>(std::min<std::uint64_t>(pacer->getOvershootUs(), 99999)));
+                pacer->resetStats();
+            }
+            append("\nHEAP %lu", static_cast<unsigned long>(getFreeHeap()));
+
+            label.setText(fonts::font_3x5, {text.data(), length});
+            assert(!label.truncated);
+        }
+    };
+
+} // namespace picon::graphics
@@ -2,9 +2,19 @@
 
 #include "color.hpp"
 
+#include "math/rect.hpp"
+#include "memory/allocator.hpp"
+#include "utils/bit_utils.hpp"
+#include "utils/types.hpp"
+
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 
 namespace picon::graphics {
@@ -40,27 +50,31 @@ namespace picon::graphics {
 
 
     /// non-owning view of image data, runtime size.
+    /// drawing into it is clipped to scissor, which ClipStack narrows.
     template <color::ColorType T_Format>
     struct Image
     {
         using Format = T_Format;
+        using Rect = math::Rect<utils::isize_t>;
 
         std::size_t width;
         std::size_t height;
         Format* addr;
+        /// always inside the image, the whole image unless clipped.
+        Rect scissor;
 
         constexpr Image(std::size_t p_width, std::size_t p_height, Format* p_addr) :
-            width{p_width}, height{p_height}, addr{p_addr}
+            width{p_width}, height{p_height}, addr{p_addr}, scissor{getBounds()}
         {}
 
         template <std::size_t t_width, std::size_t t_height>
         constexpr Image(ImageData<Format, t_width, t_height> &p_image_data) :
-            width{t_width}, height{t_height}, addr{p_image_data.storage.data()}
+            width{t_width}, height{t_height}, addr{p_image_data.storage.data()}, scissor{getBounds()}
         {}
 
         template <std::size_t t_width, std::size_t t_height>
         constexpr Image(const ImageData<Format, t_width, t_height> &p_image_data) :
-            width{t_width}, height{t_height}, addr{p_image_data.storage.data()}
+            width{t_width}, height{t_height}, addr{p_image_data.storage.data()}, scissor{getBounds()}
         {}
         
         constexpr Image(const Image&) = default;
@@ -69,6 +83,17 @@ namespace picon::graphics {
         Image& operator=(Image&&) noexcept = default;
         ~Image() = default;
 
+        constexpr Rect getBounds() const
+        {
+            return {{0, 0}, {static_cast<utils::isize_t>(width), static_cast<utils::isize_t>(height)}};
+        }
+
+        /// whether the scissor is smaller than the image.
+        constexpr bool isClipped() const
+        {
+            return scissor.size.x != static_cast<utils::isize_t>(width) || scissor.size.y != static_cast<utils::isize_t>(height);
+        }
+
         constexpr std::size_t size() const { return width * height; }
         constexpr std::size_t bytes() const { return size() * sizeof(Format); }
 
@@ -112,4 +137,167 @@ namespace picon::graphics {
         }
     };
 
+
+    /// formats narrower than a byte, stored several pixels per byte by PackedImageData.
+    template <typename T_Format>
+    concept PackedFormat =
+        color::ColorType<T_Format> &&
+        sizeof(typename T_Format::Value) == 1 &&
+        (T_Format::num_bits == 1 || T_Format::num_bits == 2 || T_Format::num_bits == 4);
+
+
+    /// owning container of sub-byte image data, e.g. I4 at two indices per byte.
+    /// rows start on a byte, the first pixel of a byte is in its high bits.
+    template <PackedFormat T_Format, std::size_t t_width, std::size_t t_height>
+    struct PackedImageData
+    {
+        using Format = T_Format;
+
+        constexpr static auto width = t_width;
+        constexpr static auto height = t_height;
+        constexpr static std::size_t pixels_per_byte = 8 / Format::num_bits;
+        /// bytes per row.
+        constexpr static std::size_t stride = (t_width + pixels_per_byte - 1) / pixels_per_byte;
+
+        std::array<std::uint8_t, stride * t_height> storage{};
+        constexpr PackedImageData() = default;
+        constexpr PackedImageData(std::array<std::uint8_t, stride * t_height> p_storage) : storage{p_storage} {}
+    };
+
+
+    /// non-owning, read only view of packed image data, runtime size.
+    /// pixels are unpacked on read, so at() returns by value.
+    template <PackedFormat T_Format>
+    struct PackedImage
+    {
+        using Format = std::remove_const_t<T_Format>;
+
+        constexpr static std::size_t pixels_per_byte = 8 / Format::num_bits;
+
+        std::size_t width;
+        std::size_t height;
+        /// bytes per row.
+        std::size_t stride;
+        const std::uint8_t* addr;
+
+        constexpr PackedImage(std::size_t p_width, std::size_t p_height, const std::uint8_t* p_addr) :
+            width{p_width}, height{p_height}, stride{(p_width + pixels_per_byte - 1) / pixels_per_byte}, addr{p_addr}
+        {}
+
+        template <std::size_t t_width, std::size_t t_height>
+        constexpr PackedImage(const PackedImageData<T_Format, t_width, t_height>& p_image_data) :
+            PackedImage{t_width, t_height, p_image_data.storage.data()}
+        {}
+
+        constexpr std::size_t bytes() const { return stride * height; }
+
+        constexpr const std::uint8_t* rowBegin(std::size_t p_y) const
+        {
+            assert(p_y < height);
+            return std::next(addr, p_y * stride);
+        }
+
+        /// the pixel of p_byte at p_i, counted from its high bits.
+        constexpr static Format unpack(std::uint8_t p_byte, std::size_t p_i)
+        {
+            const auto shift = (pixels_per_byte - 1 - p_i) * Format::num_bits;
+            return Format::fromValue(static_cast<Format::Value>((p_byte >> shift) & utils::bits<Format::num_bits>));
+        }
+
+        constexpr Format at(std::size_t p_x, std::size_t p_y) const
+        {
+            assert(p_x < width && p_y < height);
+            return unpack(rowBegin(p_y)[p_x / pixels_per_byte], p_x % pixels_per_byte);
+        }
+    };
+
+    namespace internal::test::PackedImage_
+    {
+        constexpr PackedImageData<const color::I4, 3, 2> data{{0x12, 0x30, 0x45, 0x60}};
+        constexpr PackedImage<const color::I4> image{data};
+
+        static_assert(decltype(data)::stride == 2);
+        static_assert(image.bytes() == 4);
+        static_assert(image.at(0, 0).value == 1 && image.at(1, 0).value == 2 && image.at(2, 0).value == 3);
+        static_assert(image.at(0, 1).value == 4 && image.at(1, 1).value == 5 && image.at(2, 1).value == 6);
+        static_assert(PackedImage<color::GS4>::unpack(0xA5, 0).value == 0xA);
+        static_assert(!PackedFormat<color::I8>);
+    } // namespace internal::test::PackedImage_
+
+
+    /// owning image with a runtime size, storage comes from a memory::Allocator
+    /// instead of the heap. it is its own view, so it passes wherever an Image does.
+    /// if the allocator was out of memory the image is empty, see valid().
+    /// must not outlive its allocator, or a reset of it.
+    template <color::ColorType T_Format>
+    struct ImageBuffer: public Image<T_Format>
+    {
+        using Format = T_Format;
+
+        void (*release)(void* p_allocator, void* p_ptr, std::size_t p_size){};
+        void* allocator{};
+
+        ImageBuffer() : Image<T_Format>{0, 0, nullptr} {}
+
+        template <memory::Allocator T_Allocator>
+        ImageBuffer(T_Allocator& r_allocator, std::size_t p_width, std::size_t p_height) :
+            Image<T_Format>{0, 0, nullptr}
+        {
+            const auto size = p_width * p_height;
+            const auto addr = static_cast<Format*>(r_allocator.allocate(size * sizeof(Format), alignof(Format)));
+            if (addr == nullptr) { return; }
+
+            std::uninitialized_value_construct_n(addr, size);
+            this->width = p_width;
+            this->height = p_height;
+            this->addr = addr;
+            this->scissor = this->getBounds();
+            release = [](void* p_allocator, void* p_ptr, std::size_t p_size){
+                static_cast<T_Allocator*>(p_allocator)->deallocate(p_ptr, p_size);
+            };
+            allocator = &r_allocator;
+        }
+
+        ImageBuffer(const ImageBuffer&) = delete;
+        ImageBuffer& operator=(const ImageBuffer&) = delete;
+
+        ImageBuffer(ImageBuffer&& p_other) noexcept :
+            Image<T_Format>{std::exchange(p_other.width, 0), std::exchange(p_other.height, 0), std::exchange(p_other.addr, nullptr)},
+            release{p_other.release},
+            allocator{p_other.allocator}
+        {
+            this->scissor = std::exchange(p_other.scissor, {});
+        }
+
+        ImageBuffer& operator=(ImageBuffer&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                free();
+                this->width = std::exchange(p_other.width, 0);
+                this->height = std::exchange(p_other.height, 0);
+                this->addr = std::exchange(p_other.addr, nullptr);
+                this->scissor = std::exchange(p_other.scissor, {});
+                release = p_other.release;
+                allocator = p_other.allocator;
+            }
+            return *this;
+        }
+
+        ~ImageBuffer()
+        {
+            free();
+        }
+
+        bool valid() const { return this->addr != nullptr; }
+
+    private:
+        void free()
+        {
+            if (this->addr == nullptr) { return; }
+            release(allocator, this->addr, this->bytes());
+            this->addr = nullptr;
+        }
+    };
+
 } // namespace picon::graphics
\ No newline at end of file
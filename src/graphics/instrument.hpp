@@ -0,0 +1,231 @@
+#pragma once
+
+#include "color.hpp"
+#include "convert.hpp"
+#include "image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/// define PICON_GRAPHICS_INSTRUMENT to count the pixels every drawing kernel touches.
+/// without it every hook below is an empty inline function.
+
+namespace picon::graphics::instrument
+{
+    #if defined(PICON_GRAPHICS_INSTRUMENT)
+    inline constexpr bool enabled = true;
+    #else
+    inline constexpr bool enabled = false;
+    #endif
+
+    /// the loops in graphics/functions.hpp everything else draws through.
+    enum class Kernel : std::uint8_t
+    {
+        fill,
+        blit,
+    };
+
+    /// pixels one kernel touched for one format pair and blend mode.
+    /// pixels a blend leaves unchanged, e.g. transparent ones, count too.
+    struct KernelStats
+    {
+        Kernel kernel;
+        std::string_view dst;
+        std::string_view src;
+        std::string_view blend;
+        std::size_t calls{};
+        std::size_t spans{};
+        std::size_t pixels{};
+        KernelStats* next{};
+    };
+
+    /// per pixel write counts of the image being tracked, saturating at 255.
+    struct Overdraw
+    {
+        const std::byte* begin{};
+        const std::byte* end{};
+        std::size_t pixel_size{};
+        std::uint8_t* counts{};
+    };
+
+
+    namespace internal
+    {
+        /// the compiler's spelling of T_Type, without the picon namespaces.
+        template <typename T_Type>
+        constexpr std::string_view typeName()
+        {
+            std::string_view name = std::source_location::current().function_name();
+            constexpr std::string_view key = "T_Type = ";
+            name.remove_prefix(name.find(key) + key.size());
+            name = name.substr(0, name.find_first_of(";]"));
+            for (const std::string_view prefix : {"picon::graphics::color::blend::", "picon::graphics::color::"})
+            {
+                if (name.starts_with(prefix)) { name.remove_prefix(prefix.size()); }
+            }
+            return name;
+        }
+
+        inline KernelStats* kernels{};
+        inline Overdraw* overdraw{};
+
+        template <Kernel t_kernel, color::ColorType T_DstFormat, color::ColorType T_SrcFormat, typename T_Blend>
+        KernelStats& kernelStats()
+        {
+            static KernelStats stats{
+                .kernel = t_kernel,
+                .dst = color::name<std::remove_const_t<T_DstFormat>>.data(),
+                .src = color::name<std::remove_const_t<T_SrcFormat>>.data(),
+                .blend = typeName<T_Blend>(),
+            };
+            // linked into the list on first use.
+            [[maybe_unused]] static const bool linked = (stats.next = std::exchange(kernels, &stats), true);
+            return stats;
+        }
+
+        inline void countOverdraw(const void* p_row, std::size_t p_w)
+        {
+            if (overdraw == nullptr) { return; }
+            const auto row = static_cast<const std::byte*>(p_row);
+            if (row < overdraw->begin || row >= overdraw->end) { return; }
+
+            const auto counts = overdraw->counts + (row - overdraw->begin) / overdraw->pixel_size;
+            for (std::size_t x = 0; x < p_w; ++x)
+            {
+                counts[x] += counts[x] < UINT8_MAX;
+            }
+        }
+    } // namespace internal
+
+
+    /// heatmap color of a write count, black for none, then blue, green,
+    /// yellow, orange and red, white from 6 writes on.
+    constexpr color::R8G8B8 heatColor(std::uint8_t p_count)
+    {
+        constexpr std::array<color::R8G8B8, 7> colors{{
+            {0, 0, 0},
+            {0, 0, 160},
+            {0, 160, 0},
+            {224, 224, 0},
+            {255, 128, 0},
+            {255, 0, 0},
+            {255, 255, 255},
+        }};
+        return colors[std::min<std::size_t>(p_count, colors.size() - 1)];
+    }
+
+
+    /// shadow buffer of write counts for a t_width x t_height image.
+    template <std::size_t t_width, std::size_t t_height>
+    struct OverdrawBuffer
+    {
+        constexpr static std::size_t width = t_width;
+        constexpr static std::size_t height = t_height;
+
+        std::array<std::uint8_t, t_width * t_height> counts{};
+        Overdraw overdraw{};
+
+        /// count writes into p_target from now on, which must be t_width x t_height.
+        template <color::ColorType T_Format>
+        void track(Image<T_Format> p_target)
+        {
+            if constexpr (enabled)
+            {
+                const auto begin = reinterpret_cast<const std::byte*>(p_target.data());
+                overdraw = {begin, begin + t_width * t_height * sizeof(T_Format), sizeof(T_Format), counts.data()};
+                internal::overdraw = &overdraw;
+            }
+        }
+
+        void clear()
+        {
+            counts.fill(0);
+        }
+
+        /// draw the counts into p_dst as a heatmap, see heatColor.
+        template <color::ColorType T_Format>
+        void render(Image<T_Format> p_dst) const
+        {
+            const auto h = std::min(t_height, p_dst.height);
+            const auto w = std::min(t_width, p_dst.width);
+            for (std::size_t y = 0; y < h; ++y)
+            {
+                for (std::size_t x = 0; x < w; ++x)
+                {
+                    p_dst.at(x, y) = color::convert<T_Format>(heatColor(counts[y * t_width + x]));
+                }
+            }
+        }
+    };
+
+
+    /// record one kernel call of p_h spans of p_w pixels into p_dst from p_x, p_y.
+    template <Kernel t_kernel, color::ColorType T_DstFormat, color::ColorType T_SrcFormat, typename T_Blend>
+    inline void record(Image<T_DstFormat> p_dst, std::size_t p_x, std::size_t p_y, std::size_t p_w, std::size_t p_h)
+    {
+        if constexpr (enabled)
+        {
+            auto& stats = internal::kernelStats<t_kernel, T_DstFormat, T_SrcFormat, T_Blend>();
+            ++stats.calls;
+            stats.spans += p_h;
+            stats.pixels += p_w * p_h;
+
+            for (std::size_t y = p_y; y < p_y + p_h; ++y)
+            {
+                internal::countOverdraw(p_dst.rowBegin(y) + p_x, p_w);
+            }
+        }
+    }
+
+    /// print the counters of every kernel used since the last reset, busiest first.
+    inline void printKernels()
+    {
+        if constexpr (enabled)
+        {
+            std::array<KernelStats*, 64> sorted{};
+            std::size_t num_kernels = 0;
+            for (auto stats = internal::kernels; stats != nullptr && num_kernels < sorted.size(); stats = stats->next)
+            {
+                if (stats->calls > 0) { sorted[num_kernels++] = stats; }
+            }
+            std::sort(sorted.begin(), sorted.begin() + num_kernels, [](auto p_lhs, auto p_rhs){ return p_lhs->pixels > p_rhs->pixels; });
+
+            std::printf("%-6s %-10s %-10s %10s %10s %12s  %s\n", "kernel", "dst", "src", "calls", "spans", "pixels", "blend");
+            for (std::size_t i = 0; i < num_kernels; ++i)
+            {
+                const auto& stats = *sorted[i];
+                std::printf("%-6s %-10.*s %-10.*s %10zu %10zu %12zu  %.*s\n",
+                    stats.kernel == Kernel::fill ? "fill" : "blit",
+                    static_cast<int>(stats.dst.size()), stats.dst.data(),
+                    static_cast<int>(stats.src.size()), stats.src.data(),
+                    stats.calls, stats.spans, stats.pixels,
+                    static_cast<int>(stats.blend.size()), stats.blend.data());
+            }
+        }
+    }
+
+    /// zero the counters of every kernel.
+    inline void resetKernels()
+    {
+        if constexpr (enabled)
+        {
+            for (auto stats = internal::kernels; stats != nullptr; stats = stats->next)
+            {
+                stats->calls = 0;
+                stats->spans = 0;
+                stats->pixels = 0;
+            }
+        }
+    }
+
+    static_assert(std::string_view{color::name<color::R5G5B5A1>.data()} == "R5G5B5A1");
+    static_assert(std::string_view{color::name<color::GS4>.data()} == "L4");
+
+} // namespace picon::graphics::instrument
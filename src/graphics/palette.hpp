@@ -0,0 +1,127 @@
+#pragma once
+
+#include "color.hpp"
+#include "convert.hpp"
+
+#include "utils/bit_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace picon::graphics
+{
+
+    /// owning palette of t_size colors, in any direct color format.
+    template <color::ColorType T_Format, std::size_t t_size>
+    struct Palette
+    {
+        using Format = T_Format;
+
+        constexpr static auto size = t_size;
+
+        std::array<Format, t_size> colors{};
+    };
+
+
+    /// palette pre-converted to a framebuffer format.
+    /// indexed blits read this directly, so swapping or cycling colors
+    /// costs O(palette) instead of touching every indexed pixel.
+    template <color::ColorType T_DstFormat, std::size_t t_size>
+    struct PaletteLut
+    {
+        using Format = T_DstFormat;
+
+        constexpr static auto size = t_size;
+
+        std::array<Format, t_size> colors{};
+
+        /// false for entries whose source color was fully transparent, used by blend::indexed_alpha.
+        std::array<bool, t_size> opaque{};
+
+        constexpr PaletteLut() { opaque.fill(true); }
+
+        template <color::ColorType T_SrcFormat, std::size_t t_src_size>
+        requires(t_src_size <= t_size)
+        constexpr PaletteLut(const Palette<T_SrcFormat, t_src_size>& p_palette) : PaletteLut()
+        {
+            load(p_palette);
+        }
+
+        /// convert and store every entry of p_palette.
+        template <color::ColorType T_SrcFormat, std::size_t t_src_size>
+        requires(t_src_size <= t_size)
+        constexpr void load(const Palette<T_SrcFormat, t_src_size>& p_palette)
+        {
+            for (std::size_t i = 0; i < t_src_size; ++i)
+            {
+                set(i, p_palette.colors[i]);
+            }
+        }
+
+        /// convert and store one entry.
+        template <color::ColorType T_SrcFormat>
+        constexpr void set(std::size_t p_index, T_SrcFormat p_color)
+        {
+            colors[p_index] = color::convert<Format>(p_color);
+            if constexpr (T_SrcFormat::template has_channel<color::A>)
+            {
+                opaque[p_index] = p_color.template get<color::A>() > 0;
+            }
+            else
+            {
+                opaque[p_index] = true;
+            }
+        }
+
+        /// rotate p_count entries starting at p_first by p_steps, for color cycling.
+        constexpr void rotate(std::size_t p_first, std::size_t p_count, std::size_t p_steps = 1)
+        {
+            if (p_count == 0) { return; }
+            const auto steps = p_steps % p_count;
+            std::rotate(colors.begin() + p_first, colors.begin() + p_first + steps, colors.begin() + p_first + p_count);
+            std::rotate(opaque.begin() + p_first, opaque.begin() + p_first + steps, opaque.begin() + p_first + p_count);
+        }
+
+        constexpr const Format& operator[](std::size_t p_index) const { return colors[p_index]; }
+    };
+
+
+    namespace color::blend
+    {
+        /// expands palette indices through a PaletteLut.
+        /// with t_alpha, indices whose palette entry is transparent are skipped.
+        template <ColorType T_DstFormat, std::size_t t_size, bool t_alpha>
+        struct Indexed
+        {
+            const PaletteLut<T_DstFormat, t_size>* lut;
+
+            template <ColorType T_SrcFormat>
+            requires(T_SrcFormat::template has_channel<I> && utils::bits<T_SrcFormat::template channel<I>.size> < t_size)
+            constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src) const
+            {
+                const auto index = p_src.template get<I>();
+                if constexpr (t_alpha)
+                {
+                    if (!lut->opaque[index]) { return; }
+                }
+                r_dst = lut->colors[index];
+            }
+        };
+
+        /// overwrite with palette colors.
+        template <ColorType T_DstFormat, std::size_t t_size>
+        constexpr Indexed<T_DstFormat, t_size, false> indexed(const PaletteLut<T_DstFormat, t_size>& p_lut)
+        {
+            return {&p_lut};
+        }
+
+        /// overwrite with palette colors, skipping transparent entries.
+        template <ColorType T_DstFormat, std::size_t t_size>
+        constexpr Indexed<T_DstFormat, t_size, true> indexed_alpha(const PaletteLut<T_DstFormat, t_size>& p_lut)
+        {
+            return {&p_lut};
+        }
+    } // namespace color::blend
+
+} // namespace picon::graphics
\ No newline at end of file
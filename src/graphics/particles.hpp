@@ -0,0 +1,151 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+
+#include "math/fixed.hpp"
+#include "math/point.hpp"
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+
+namespace picon::graphics
+{
+
+    /// fixed capacity particle system, stored as a structure of arrays so the
+    /// update is a handful of straight loops over one field each.
+    /// dead particles are compacted in place, keeping the order of the living.
+    /// positions are sprite centers in pixels, velocities in pixels per second.
+    /// @tparam t_capacity
+    /// @tparam T_Unit
+    template <std::size_t t_capacity, typename T_Unit = math::Fixed<15, 16>>
+    struct ParticleSystem
+    {
+        using Unit = T_Unit;
+
+        constexpr static auto capacity = t_capacity;
+
+        std::array<Unit, t_capacity> x{};
+        std::array<Unit, t_capacity> y{};
+        std::array<Unit, t_capacity> velocity_x{};
+        std::array<Unit, t_capacity> velocity_y{};
+        /// remaining lifetime in microseconds, dead at or below zero.
+        std::array<std::int32_t, t_capacity> lifetime_us{};
+        std::array<std::uint8_t, t_capacity> sprite{};
+        std::size_t num_particles{};
+
+        /// added to every velocity, in pixels per second squared.
+        math::Point<Unit> gravity{};
+
+        /// returns false if the system is full.
+        bool spawn(math::Point<Unit> p_position, math::Point<Unit> p_velocity, std::int32_t p_lifetime_us, std::uint8_t p_sprite)
+        {
+            if (num_particles == t_capacity) { return false; }
+
+            const auto i = num_particles++;
+            x[i] = p_position.x;
+            y[i] = p_position.y;
+            velocity_x[i] = p_velocity.x;
+            velocity_y[i] = p_velocity.y;
+            lifetime_us[i] = p_lifetime_us;
+            sprite[i] = p_sprite;
+            return true;
+        }
+
+        /// advance every particle by p_delta_us, then drop the dead ones.
+        void update(std::uint64_t p_delta_us)
+        {
+            const auto delta = Unit::fromRatio(p_delta_us, std::micro::den);
+            const auto delta_us = static_cast<std::int32_t>(std::min<std::uint64_t>(p_delta_us, INT32_MAX));
+            const auto n = num_particles;
+
+            if (gravity.x != 0)
+            {
+                const auto dv = gravity.x * delta;
+                for (std::size_t i = 0; i < n; ++i) { velocity_x[i] += dv; }
+            }
+            if (gravity.y != 0)
+            {
+                const auto dv = gravity.y * delta;
+                for (std::size_t i = 0; i < n; ++i) { velocity_y[i] += dv; }
+            }
+
+            for (std::size_t i = 0; i < n; ++i) { x[i] += velocity_x[i] * delta; }
+            for (std::size_t i = 0; i < n; ++i) { y[i] += velocity_y[i] * delta; }
+            for (std::size_t i = 0; i < n; ++i) { lifetime_us[i] -= delta_us; }
+
+            compact();
+        }
+
+        /// draw every particle of sprite type p_sprite as p_image, in one pass.
+        /// particles are tested against the scissor shrunk by the image size, so
+        /// only those straddling its edge are clipped per blit.
+        /// the blend mode is bound to the formats once for all of them.
+        template <
+            color::ColorType T_DstFormat,
+            color::ColorType T_SrcFormat,
+            color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+        >
+        void draw(Image<T_DstFormat> p_dst, std::uint8_t p_sprite, const Image<T_SrcFormat> p_image, T_Blend p_blend = {}) const
+        {
+            const auto w = static_cast<utils::isize_t>(p_image.width);
+            const auto h = static_cast<utils::isize_t>(p_image.height);
+
+            // top left corners of images fully inside the scissor, or touching it at all.
+            const auto inside_begin = p_dst.scissor.position;
+            const auto inside_end = p_dst.scissor.end() - math::Point<utils::isize_t>{w, h};
+            const auto touch_begin = p_dst.scissor.position - math::Point<utils::isize_t>{w, h};
+            const auto touch_end = p_dst.scissor.end();
+
+            auto&& blend = color::blend::bind<T_DstFormat, T_SrcFormat>(p_blend);
+
+            for (std::size_t i = 0; i < num_particles; ++i)
+            {
+                if (sprite[i] != p_sprite) { continue; }
+
+                const auto px = static_cast<utils::isize_t>(x[i]) - w / 2;
+                const auto py = static_cast<utils::isize_t>(y[i]) - h / 2;
+
+                if (px >= inside_begin.x && px <= inside_end.x && py >= inside_begin.y && py <= inside_end.y)
+                {
+                    fn::internal::blitUnclipped(p_dst, px, py, p_image, 0, 0, p_image.width, p_image.height, blend);
+                }
+                else if (px > touch_begin.x && px < touch_end.x && py > touch_begin.y && py < touch_end.y)
+                {
+                    fn::blitSafe(p_dst, px, py, p_image, blend);
+                }
+            }
+        }
+
+        constexpr std::size_t size() const
+        {
+            return num_particles;
+        }
+
+    private:
+        /// move the living particles down over the dead ones.
+        /// branch free, every particle is copied to the write index, which only advances for the living.
+        void compact()
+        {
+            std::size_t num_alive = 0;
+            for (std::size_t i = 0; i < num_particles; ++i)
+            {
+                x[num_alive] = x[i];
+                y[num_alive] = y[i];
+                velocity_x[num_alive] = velocity_x[i];
+                velocity_y[num_alive] = velocity_y[i];
+                lifetime_us[num_alive] = lifetime_us[i];
+                sprite[num_alive] = sprite[i];
+                num_alive += lifetime_us[i] > 0;
+            }
+            num_particles = num_alive;
+        }
+    };
+
+} // namespace picon::graphics
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "image.hpp"
+#include "particles.hpp"
+
+#include "time/time.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <ratio>
+
+namespace picon::graphics
+{
+
+    /// print the update and draw cost of p_num_particles 4x4 alpha sprites on a
+    /// 256x64 frame, refilled every frame as they expire, and how many particles
+    /// that sustains at 60 Hz.
+    template <std::size_t t_capacity>
+    void benchmarkParticles(std::size_t p_num_particles, std::size_t p_num_frames = 120)
+    {
+        using System = ParticleSystem<t_capacity>;
+        using Unit = System::Unit;
+
+        const auto system = std::make_unique<System>();
+        system->gravity = {0, 32};
+
+        ImageData<color::R4G4B4A4, 256, 64> frame{};
+        ImageData<color::R5G5B5A1, 4, 4> sprite{{{
+            {0, 0, 0, 0}, {31, 0, 0, 1}, {31, 0, 0, 1}, {0, 0, 0, 0},
+            {31, 0, 0, 1}, {31, 31, 0, 1}, {31, 31, 0, 1}, {31, 0, 0, 1},
+            {31, 0, 0, 1}, {31, 31, 0, 1}, {31, 31, 0, 1}, {31, 0, 0, 1},
+            {0, 0, 0, 0}, {31, 0, 0, 1}, {31, 0, 0, 1}, {0, 0, 0, 0},
+        }}};
+
+        std::minstd_rand random{1};
+        const auto spawn = [&](){
+            while (system->size() < p_num_particles)
+            {
+                system->spawn(
+                    {static_cast<Unit>(random() % 256), static_cast<Unit>(random() % 64)},
+                    {static_cast<Unit>(random() % 64) - 32, static_cast<Unit>(random() % 64) - 48},
+                    500'000 + random() % 1'500'000,
+                    0);
+            }
+        };
+        spawn();
+
+        std::uint64_t update_us{};
+        std::uint64_t draw_us{};
+        for (std::size_t i = 0; i < p_num_frames; ++i)
+        {
+            const auto update_start = time::getEpochTimeUs64();
+            system->update(std::micro::den / 60);
+            spawn();
+            const auto draw_start = time::getEpochTimeUs64();
+            system->draw(Image<color::R4G4B4A4>{frame}, 0, Image<color::R5G5B5A1>{sprite}, color::blend::alpha);
+            const auto draw_end = time::getEpochTimeUs64();
+
+            update_us += draw_start - update_start;
+            draw_us += draw_end - draw_start;
+        }
+
+        const auto frame_us = static_cast<double>(update_us + draw_us) / p_num_frames;
+        std::printf("%8zu particles %8.1f us update %8.1f us draw %10.0f particles at 60 Hz\n",
+            p_num_particles,
+            static_cast<double>(update_us) / p_num_frames,
+            static_cast<double>(draw_us) / p_num_frames,
+            frame_us > 0 ? p_num_particles * (std::micro::den / 60.0) / frame_us : 0.0);
+    }
+
+    inline void benchmarkParticles()
+    {
+        for (const auto num_particles : {1024, 4096, 16384})
+        {
+            benchmarkParticles<16384>(num_particles);
+        }
+    }
+
+} // namespace picon::graphics
@@ -0,0 +1,342 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "convert.hpp"
+#include "dither.hpp"
+
+#include "utils/bit_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace picon::graphics::color
+{
+    /// pixel operator of a pipe, returns p_src changed but in its own format.
+    template <typename T_Stage, typename T_Color>
+    concept PixelStage =
+        ColorType<T_Color> &&
+        requires(const T_Stage stage, T_Color color, std::size_t x, std::size_t y)
+        {
+            { stage(color, x, y) } -> std::same_as<T_Color>;
+        };
+
+
+    /// pixel stage that precomputes per source format, e.g. lookup tables, in bind<T_Color>().
+    template <typename T_Stage, typename T_Color>
+    concept BindableStage = requires(const T_Stage stage)
+    {
+        stage.template bind<T_Color>();
+    };
+
+
+    namespace internal
+    {
+        /// p_color with p_fn.operator()<T_Channel>(value) applied to the value of every channel.
+        template <ColorType T_Color, typename T_Fn>
+        constexpr T_Color mapChannels(T_Color p_color, T_Fn p_fn)
+        {
+            return [&]<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>) -> T_Color
+            {
+                return {
+                    static_cast<T_Value>(p_fn.template operator()<decltype(t_channels)>(p_color.template get<decltype(t_channels)>()))...
+                };
+            }(p_color);
+        }
+
+        /// widest channel of T_Color.
+        template <ColorType T_Color>
+        inline constexpr std::size_t max_channel_size = []<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>)
+        {
+            return std::max({t_channels.size...});
+        }(T_Color{});
+
+        /// the stage to run per pixel for T_Color, its bind<T_Color>() if it precomputes.
+        template <ColorType T_Color, typename T_Stage>
+        constexpr auto bindStage(const T_Stage& p_stage)
+        {
+            if constexpr (BindableStage<T_Stage, T_Color>)
+            {
+                return p_stage.template bind<T_Color>();
+            }
+            else
+            {
+                return p_stage;
+            }
+        }
+
+        /// centered 4x4 bayer threshold at p_x, p_y, in [0, 255).
+        constexpr std::uint32_t bayerThreshold(std::size_t p_x, std::size_t p_y)
+        {
+            return (bayer_4x4[(p_y % 4) * 4 + (p_x % 4)] * 2 + 1) * 255 / 32;
+        }
+    } // namespace internal
+
+
+    /// tint through per channel tables, see Tint::bind.
+    /// entries are already shifted into place, a pixel is the or of one lookup per channel.
+    template <ColorType T_Color>
+    struct TintLut
+    {
+        std::array<std::array<typename T_Color::Value, utils::bits<internal::max_channel_size<T_Color>> + 1>, T_Color::num_channels> lut;
+
+        constexpr T_Color operator()(T_Color p_src, std::size_t, std::size_t) const
+        {
+            return [&]<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>)
+            {
+                return T_Color::fromValue((lut[T_Color::template channel_index<decltype(t_channels)>][p_src.template get<decltype(t_channels)>()] | ...));
+            }(p_src);
+        }
+    };
+
+    /// multiply the color channels of the source by color, converted to the source format.
+    /// alpha is kept.
+    template <ColorType T_TintColor>
+    struct Tint
+    {
+        T_TintColor color;
+
+        template <ColorType T_Color>
+        requires(!T_Color::template has_channel<I>)
+        constexpr T_Color operator()(T_Color p_src, std::size_t, std::size_t) const
+        {
+            const auto tint = convert<T_Color>(color);
+            return internal::mapChannels(p_src, [&]<ChannelType T_Channel>(auto p_value)
+            {
+                return multiply<T_Color, T_Channel>(p_value, tint.template get<T_Channel>());
+            });
+        }
+
+        /// per channel tables of every product, for sources of up to 6 bits a channel.
+        /// wider channels are cheaper to multiply than to tabulate per draw.
+        template <ColorType T_Color>
+        requires(!T_Color::template has_channel<I> && internal::max_channel_size<T_Color> <= 6)
+        constexpr TintLut<T_Color> bind() const
+        {
+            const auto tint = convert<T_Color>(color);
+            TintLut<T_Color> result{};
+            [&]<typename T_Value, auto... t_channels>(Color<T_Value, t_channels...>)
+            {
+                ([&]()
+                {
+                    using Channel = decltype(t_channels);
+                    constexpr auto channel = T_Color::template channel<Channel>;
+                    auto& lut = result.lut[T_Color::template channel_index<Channel>];
+                    for (std::size_t value = 0; value <= utils::bits<channel.size>; ++value)
+                    {
+                        lut[value] = utils::setBits<channel.offset, channel.size>(
+                            static_cast<T_Value>(multiply<T_Color, Channel>(value, tint.template get<Channel>())));
+                    }
+                }(), ...);
+            }(T_Color{});
+            return result;
+        }
+
+    private:
+        template <ColorType T_Color, ChannelType T_Channel>
+        constexpr static std::uint32_t multiply(std::uint32_t p_value, std::uint32_t p_tint)
+        {
+            if constexpr (ChannelOfType<A, T_Channel>) { return p_value; }
+            else
+            {
+                constexpr std::uint32_t max = utils::bits<T_Color::template channel<T_Channel>.size>;
+                return (p_value * p_tint + max / 2) / max;
+            }
+        }
+    };
+
+    template <ColorType T_TintColor>
+    constexpr Tint<T_TintColor> tint(T_TintColor p_color)
+    {
+        return {p_color};
+    }
+
+
+    /// fade through a table per 4x4 dither position, see Fade::bind.
+    /// entries are alpha shifted into place.
+    template <ColorType T_Color>
+    struct FadeLut
+    {
+        std::array<std::array<typename T_Color::Value, utils::bits<T_Color::template channel<A>.size> + 1>, bayer_4x4.size()> lut;
+
+        constexpr T_Color operator()(T_Color p_src, std::size_t p_x, std::size_t p_y) const
+        {
+            constexpr auto alpha = T_Color::template channel<A>;
+            constexpr auto mask = utils::setBits<alpha.offset, alpha.size>(~typename T_Color::Value{});
+            return T_Color::fromValue((p_src.value & ~mask) | lut[(p_y % 4) * 4 + (p_x % 4)][p_src.template get<A>()]);
+        }
+    };
+
+    /// scale the source alpha by amount / 255, ordered dithered so that
+    /// sources with few alpha bits fade as a screen door instead of all at once.
+    struct Fade
+    {
+        std::uint8_t amount;
+
+        template <ColorType T_Color>
+        requires(T_Color::template has_channel<A>)
+        constexpr T_Color operator()(T_Color p_src, std::size_t p_x, std::size_t p_y) const
+        {
+            constexpr auto alpha = T_Color::template channel<A>;
+            constexpr auto mask = utils::setBits<alpha.offset, alpha.size>(~typename T_Color::Value{});
+            const auto value = fade(p_src.template get<A>(), internal::bayerThreshold(p_x, p_y));
+            return T_Color::fromValue((p_src.value & ~mask) | utils::setBits<alpha.offset, alpha.size>(static_cast<typename T_Color::Value>(value)));
+        }
+
+        /// one table per dither position, for sources of up to 4 alpha bits.
+        template <ColorType T_Color>
+        requires(T_Color::template has_channel<A> && T_Color::template channel<A>.size <= 4)
+        constexpr FadeLut<T_Color> bind() const
+        {
+            constexpr auto alpha = T_Color::template channel<A>;
+            FadeLut<T_Color> result{};
+            for (std::size_t pos = 0; pos < result.lut.size(); ++pos)
+            {
+                for (std::size_t value = 0; value < result.lut[pos].size(); ++value)
+                {
+                    result.lut[pos][value] = utils::setBits<alpha.offset, alpha.size>(
+                        static_cast<typename T_Color::Value>(fade(value, internal::bayerThreshold(pos % 4, pos / 4))));
+                }
+            }
+            return result;
+        }
+
+    private:
+        constexpr std::uint32_t fade(std::uint32_t p_alpha, std::uint32_t p_threshold) const
+        {
+            return (p_alpha * amount + p_threshold) / 255;
+        }
+    };
+
+    constexpr Fade fade(std::uint8_t p_amount)
+    {
+        return {p_amount};
+    }
+
+
+    /// pixel stages followed by a blend mode, fused into one blend mode.
+    /// every stage runs on the source pixel in turn, then the blend writes it,
+    /// so a draw stays one pass over its pixels however many stages there are.
+    /// e.g. blit(fb, x, y, src, pipe(tint(c), fade(a), blend::alpha)).
+    /// @tparam T_Parts the stages, then the blend mode
+    template <typename... T_Parts>
+    requires(sizeof...(T_Parts) >= 1)
+    struct Pipe
+    {
+        constexpr static std::size_t num_stages = sizeof...(T_Parts) - 1;
+
+        std::tuple<T_Parts...> parts;
+
+        template <std::size_t t_index>
+        using Part = std::tuple_element_t<t_index, std::tuple<T_Parts...>>;
+
+        using Blend = Part<num_stages>;
+
+        template <ColorType T_DstFormat, ColorType T_SrcFormat>
+        constexpr static bool accepts = []<std::size_t... t_i>(std::index_sequence<t_i...>)
+        {
+            return (PixelStage<Part<t_i>, T_SrcFormat> && ... && blend::BlendMode<Blend, T_DstFormat, T_SrcFormat>);
+        }(std::make_index_sequence<num_stages>{});
+
+        template <ColorType T_DstFormat, ColorType T_SrcFormat>
+        constexpr static bool binds = []<std::size_t... t_i>(std::index_sequence<t_i...>)
+        {
+            return (BindableStage<Part<t_i>, T_SrcFormat> || ... || blend::BindableBlendMode<Blend, T_DstFormat, T_SrcFormat>);
+        }(std::make_index_sequence<num_stages>{});
+
+        template <ColorType T_DstFormat, ColorType T_SrcFormat>
+        requires(accepts<T_DstFormat, T_SrcFormat>)
+        constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src, std::size_t p_x, std::size_t p_y)
+        {
+            [&]<std::size_t... t_i>(std::index_sequence<t_i...>)
+            {
+                ((p_src = std::get<t_i>(parts)(p_src, p_x, p_y)), ...);
+            }(std::make_index_sequence<num_stages>{});
+
+            blend::apply(std::get<num_stages>(parts), r_dst, p_src, p_x, p_y);
+        }
+
+        /// the pipe with every stage that can precompute for the given formats, once per draw.
+        template <ColorType T_DstFormat, ColorType T_SrcFormat>
+        requires(accepts<T_DstFormat, T_SrcFormat> && binds<T_DstFormat, T_SrcFormat>)
+        constexpr auto bind() const
+        {
+            auto last = std::get<num_stages>(parts);
+            return [&]<std::size_t... t_i>(std::index_sequence<t_i...>)
+            {
+                return Pipe<decltype(internal::bindStage<T_SrcFormat>(std::get<t_i>(parts)))..., std::remove_cvref_t<decltype(blend::bind<T_DstFormat, T_SrcFormat>(last))>>{{
+                    internal::bindStage<T_SrcFormat>(std::get<t_i>(parts))...,
+                    blend::bind<T_DstFormat, T_SrcFormat>(last),
+                }};
+            }(std::make_index_sequence<num_stages>{});
+        }
+    };
+
+    template <typename... T_Parts>
+    constexpr Pipe<T_Parts...> pipe(T_Parts... p_parts)
+    {
+        return {{p_parts...}};
+    }
+
+
+    static_assert(tint(R8G8B8{255, 0, 128})(R5G5B5A1{31, 31, 31, 1}, 0, 0) == R5G5B5A1{31, 0, 16, 1});
+    static_assert(tint(R8G8B8{255, 255, 255})(GS4A1{9, 0}, 0, 0) == GS4A1{9, 0});
+
+    // the tables match the arithmetic for every channel value.
+    static_assert([](){
+        constexpr auto stage = tint(R8G8B8{200, 100, 50});
+        constexpr auto bound = stage.bind<R5G6B5>();
+        for (std::uint16_t value = 0; value < 64; ++value)
+        {
+            const R5G6B5 src{value & 31, value, value & 31};
+            if (stage(src, 0, 0) != bound(src, 0, 0)) { return false; }
+        }
+        return true;
+    }());
+
+    // half a 1 bit alpha keeps half the pixels of each 4x4 block.
+    static_assert([](){
+        constexpr auto stage = fade(128);
+        std::size_t num_kept = 0;
+        for (std::size_t pos = 0; pos < 16; ++pos)
+        {
+            num_kept += stage(R5G5B5A1{31, 31, 31, 1}, pos % 4, pos / 4).get<A>();
+        }
+        return num_kept;
+    }() == 8);
+    static_assert(fade(255)(R4G4B4A4{1, 2, 3, 15}, 3, 1) == R4G4B4A4{1, 2, 3, 15});
+    static_assert(fade(0)(R4G4B4A4{1, 2, 3, 15}, 3, 1) == R4G4B4A4{1, 2, 3, 0});
+    static_assert([](){
+        constexpr auto stage = fade(77);
+        constexpr auto bound = stage.bind<R4G4B4A4>();
+        for (std::uint16_t alpha = 0; alpha < 16; ++alpha)
+        {
+            for (std::size_t pos = 0; pos < 16; ++pos)
+            {
+                const R4G4B4A4 src{1, 2, 3, alpha};
+                if (stage(src, pos % 4, pos / 4) != bound(src, pos % 4, pos / 4)) { return false; }
+            }
+        }
+        return true;
+    }());
+
+    static_assert([](){
+        R4G4B4A4 dst{0, 0, 0, 0};
+        auto stages = pipe(tint(R8G8B8{255, 0, 0}), fade(255), blend::alpha);
+        blend::apply(stages, dst, R5G5B5A1{31, 31, 31, 1}, 0, 0);
+        return dst;
+    }() == R4G4B4A4{15, 0, 0, 15});
+    static_assert([](){
+        R4G4B4A4 dst{0, 0, 0, 0};
+        auto stages = pipe(tint(R8G8B8{255, 0, 0}), fade(0), blend::alpha).bind<R4G4B4A4, R5G5B5A1>();
+        blend::apply(stages, dst, R5G5B5A1{31, 31, 31, 1}, 0, 0);
+        return dst;
+    }() == R4G4B4A4{0, 0, 0, 0});
+    static_assert(!Pipe<Fade, blend::None>::accepts<R4G4B4A4, R5G6B5>);
+
+} // namespace picon::graphics::color
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+#include "pipe.hpp"
+
+#include "time/time.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+namespace picon::graphics
+{
+
+    /// print the cost of a tinted, faded alpha blit of a 256x64 frame, fused
+    /// into one pass by a pipe and as a pass per effect over a copy of the source.
+    inline void benchmarkPipe(std::size_t p_num_frames = 64)
+    {
+        using Src = color::R5G5B5A1;
+        using Dst = color::R4G4B4A4;
+
+        const auto frame = std::make_unique<ImageData<Dst, 256, 64>>();
+        const auto source = std::make_unique<ImageData<Src, 256, 64>>();
+        const auto scratch = std::make_unique<ImageData<Src, 256, 64>>();
+        for (std::size_t i = 0; i < source->storage.size(); ++i)
+        {
+            source->storage[i] = Src{i & 31, (i >> 5) & 31, (i >> 10) & 31, i & 1};
+        }
+
+        const auto tint = color::tint(color::R8G8B8{255, 160, 200});
+        const auto fade = color::fade(160);
+
+        const auto fused_start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_frames; ++i)
+        {
+            fn::blit(Image<Dst>{*frame}, 0, 0, Image<Src>{*source}, color::pipe(tint, fade, color::blend::alpha));
+        }
+        const auto fused_us = time::getEpochTimeUs64() - fused_start;
+
+        const auto passes_start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_frames; ++i)
+        {
+            fn::blit(Image<Src>{*scratch}, 0, 0, Image<Src>{*source});
+            Image<Src> pixels{*scratch};
+            for (std::size_t y = 0; y < pixels.height; ++y)
+            {
+                for (std::size_t x = 0; x < pixels.width; ++x) { pixels.at(x, y) = tint(pixels.at(x, y), x, y); }
+            }
+            for (std::size_t y = 0; y < pixels.height; ++y)
+            {
+                for (std::size_t x = 0; x < pixels.width; ++x) { pixels.at(x, y) = fade(pixels.at(x, y), x, y); }
+            }
+            fn::blit(Image<Dst>{*frame}, 0, 0, Image<Src>{*scratch}, color::blend::alpha);
+        }
+        const auto passes_us = time::getEpochTimeUs64() - passes_start;
+
+        std::printf("tint, fade, alpha %8.1f us fused %8.1f us in passes\n",
+            static_cast<double>(fused_us) / p_num_frames,
+            static_cast<double>(passes_us) / p_num_frames);
+    }
+
+} // namespace picon::graphics
@@ -0,0 +1,655 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+
+#include "math/point.hpp"
+#include "math/rect.hpp"
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace picon::graphics::fn
+{
+
+    /// max number of non-horizontal edges accepted by fillPolygon.
+    constexpr std::size_t max_polygon_edges = 64;
+
+
+    namespace internal
+    {
+        /// pixels x0 to x1 (inclusive) of row y, empty when x1 < x0.
+        struct Span
+        {
+            utils::isize_t x0;
+            utils::isize_t x1;
+            utils::isize_t y;
+
+            constexpr bool operator==(const Span&) const = default;
+        };
+
+        /// p_span clipped to p_scissor, empty if nothing is left.
+        constexpr Span clipSpan(Span p_span, math::Rect<utils::isize_t> p_scissor)
+        {
+            const auto clip_begin = p_scissor.position;
+            const auto clip_end = p_scissor.end();
+            if (p_span.y < clip_begin.y || p_span.y >= clip_end.y) { return {0, -1, p_span.y}; }
+
+            return {
+                std::max<utils::isize_t>(p_span.x0, clip_begin.x),
+                std::min<utils::isize_t>(p_span.x1, clip_end.x - 1),
+                p_span.y,
+            };
+        }
+
+        /// the spans p_walk(span_fn) emits, for static_assert tests.
+        /// all zero unless there are exactly t_count of them.
+        template <std::size_t t_count, typename T_Walk>
+        constexpr std::array<Span, t_count> collectSpans(T_Walk&& p_walk)
+        {
+            std::array<Span, t_count> spans{};
+            std::size_t count = 0;
+            p_walk([&](utils::isize_t p_x0, utils::isize_t p_x1, utils::isize_t p_y){
+                if (count < t_count) { spans[count] = {p_x0, p_x1, p_y}; }
+                ++count;
+            });
+            return count == t_count ? spans : std::array<Span, t_count>{};
+        }
+
+        namespace test::clipSpan_
+        {
+            constexpr math::Rect<utils::isize_t> scissor{{2, 1}, {4, 3}};
+
+            static_assert(clipSpan({3, 4, 2}, scissor) == Span{3, 4, 2});
+            static_assert(clipSpan({0, 9, 1}, scissor) == Span{2, 5, 1});
+            static_assert(clipSpan({-5, 2, 3}, scissor) == Span{2, 2, 3});
+            static_assert(clipSpan({5, 7, 3}, scissor) == Span{5, 5, 3});
+            // rows above and below the scissor.
+            static_assert(clipSpan({2, 5, 0}, scissor).x1 < clipSpan({2, 5, 0}, scissor).x0);
+            static_assert(clipSpan({2, 5, 4}, scissor).x1 < clipSpan({2, 5, 4}, scissor).x0);
+            // left and right of the scissor.
+            static_assert(clipSpan({0, 1, 2}, scissor).x1 < clipSpan({0, 1, 2}, scissor).x0);
+            static_assert(clipSpan({6, 9, 2}, scissor).x1 < clipSpan({6, 9, 2}, scissor).x0);
+        } // namespace test::clipSpan_
+    } // namespace internal
+
+
+    /// safe fill span.
+    /// fills pixels p_x0 to p_x1 (inclusive) of row p_y, clipped to the scissor of p_dst.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillSpanSafe(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x0, utils::isize_t p_x1, utils::isize_t p_y,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        const auto span = internal::clipSpan({p_x0, p_x1, p_y}, p_dst.scissor);
+        if (span.x1 < span.x0) { return; }
+
+        internal::fillSpanUnclipped(p_dst, span.x0, span.y, span.x1 - span.x0 + 1, p_value, p_blend);
+    }
+
+
+    /// whether the inclusive bounds p_x0, p_y0 to p_x1, p_y1 touch the scissor of p_dst.
+    template <color::ColorType T_DstFormat>
+    inline bool boundsInView(
+        const Image<T_DstFormat> p_dst,
+        utils::isize_t p_x0, utils::isize_t p_y0,
+        utils::isize_t p_x1, utils::isize_t p_y1
+    )
+    {
+        const auto clip_begin = p_dst.scissor.position;
+        const auto clip_end = p_dst.scissor.end();
+        return
+            p_x1 >= clip_begin.x && p_x0 < clip_end.x &&
+            p_y1 >= clip_begin.y && p_y0 < clip_end.y;
+    }
+
+
+    namespace internal
+    {
+        /// walks the midpoint circle of radius p_r one row at a time.
+        /// calls p_row(dy, lo, hi) once for each dy in [0, p_r], where lo to hi
+        /// (inclusive) are the x offsets of the outline's right-hand run on that row.
+        template <typename T_RowFn>
+        constexpr void circleRows(utils::isize_t p_r, T_RowFn&& p_row)
+        {
+            utils::isize_t x = 0;
+            utils::isize_t y = p_r;
+            utils::isize_t d = 1 - p_r;
+            utils::isize_t run_lo = 0;
+
+            while (x <= y)
+            {
+                // octant below the diagonal is one pixel per row.
+                if (x < y) { p_row(x, y, y); }
+
+                if (d < 0)
+                {
+                    d += 2 * x + 3;
+                }
+                else
+                {
+                    // octant above the diagonal is a horizontal run per row.
+                    p_row(y, run_lo, x);
+                    d += 2 * (x - y) + 5;
+                    --y;
+                    run_lo = x + 1;
+                }
+                ++x;
+            }
+
+            if (run_lo <= y) { p_row(y, run_lo, x - 1); }
+        }
+
+        /// collects the rows produced by circleRows, for static_assert tests.
+        template <std::size_t t_r>
+        constexpr auto circleRowsTable()
+        {
+            std::array<std::array<utils::isize_t, 2>, t_r + 1> result{};
+            std::array<std::size_t, t_r + 1> count{};
+            circleRows(t_r, [&](utils::isize_t p_dy, utils::isize_t p_lo, utils::isize_t p_hi){
+                result[p_dy] = {p_lo, p_hi};
+                ++count[p_dy];
+            });
+            for (auto c : count) { if (c != 1) { return decltype(result){}; } }
+            return result;
+        }
+
+        namespace test::circleRows_
+        {
+            using Rows = std::array<std::array<utils::isize_t, 2>, 4>;
+
+            static_assert(circleRowsTable<1>()[0] == std::array<utils::isize_t, 2>{1, 1});
+            static_assert(circleRowsTable<1>()[1] == std::array<utils::isize_t, 2>{0, 0});
+
+            static_assert(circleRowsTable<3>() == Rows{{ {3, 3}, {3, 3}, {2, 2}, {0, 1} }});
+        } // namespace test::circleRows_
+
+
+        /// walks the bresenham line from p_x0, p_y0 to p_x1, p_y1, both included.
+        /// calls p_span(x0, x1, y) once per run of pixels on the same row, in line order.
+        template <typename T_SpanFn>
+        constexpr void lineSpans(
+            utils::isize_t p_x0, utils::isize_t p_y0,
+            utils::isize_t p_x1, utils::isize_t p_y1,
+            T_SpanFn&& p_span
+        )
+        {
+            const utils::isize_t dx = p_x0 < p_x1 ? p_x1 - p_x0 : p_x0 - p_x1;
+            const utils::isize_t dy = p_y0 < p_y1 ? p_y0 - p_y1 : p_y1 - p_y0;
+            const utils::isize_t sx = p_x0 < p_x1 ? 1 : -1;
+            const utils::isize_t sy = p_y0 < p_y1 ? 1 : -1;
+            utils::isize_t err = dx + dy;
+            utils::isize_t run_x = p_x0;
+
+            while (true)
+            {
+                if (p_x0 == p_x1 && p_y0 == p_y1)
+                {
+                    p_span(std::min(run_x, p_x0), std::max(run_x, p_x0), p_y0);
+                    return;
+                }
+
+                const auto e2 = 2 * err;
+                if (e2 <= dx)
+                {
+                    p_span(std::min(run_x, p_x0), std::max(run_x, p_x0), p_y0);
+                    if (e2 >= dy) { err += dy; p_x0 += sx; }
+                    err += dx;
+                    p_y0 += sy;
+                    run_x = p_x0;
+                }
+                else
+                {
+                    err += dy;
+                    p_x0 += sx;
+                }
+            }
+        }
+
+        namespace test::lineSpans_
+        {
+            template <std::size_t t_count>
+            constexpr auto line(utils::isize_t p_x0, utils::isize_t p_y0, utils::isize_t p_x1, utils::isize_t p_y1)
+            {
+                return collectSpans<t_count>([&](auto p_span){ lineSpans(p_x0, p_y0, p_x1, p_y1, p_span); });
+            }
+
+            using Spans2 = std::array<Span, 2>;
+            using Spans4 = std::array<Span, 4>;
+
+            // one line per octant, starting and ending on the endpoints.
+            static_assert(line<2>(0, 0, 3, 1) == Spans2{{ {0, 1, 0}, {2, 3, 1} }});
+            static_assert(line<4>(0, 0, 1, 3) == Spans4{{ {0, 0, 0}, {0, 0, 1}, {1, 1, 2}, {1, 1, 3} }});
+            static_assert(line<4>(0, 0, -1, 3) == Spans4{{ {0, 0, 0}, {0, 0, 1}, {-1, -1, 2}, {-1, -1, 3} }});
+            static_assert(line<2>(0, 0, -3, 1) == Spans2{{ {-1, 0, 0}, {-3, -2, 1} }});
+            static_assert(line<2>(0, 0, -3, -1) == Spans2{{ {-1, 0, 0}, {-3, -2, -1} }});
+            static_assert(line<4>(0, 0, -1, -3) == Spans4{{ {0, 0, 0}, {0, 0, -1}, {-1, -1, -2}, {-1, -1, -3} }});
+            static_assert(line<4>(0, 0, 1, -3) == Spans4{{ {0, 0, 0}, {0, 0, -1}, {1, 1, -2}, {1, 1, -3} }});
+            static_assert(line<2>(0, 0, 3, -1) == Spans2{{ {0, 1, 0}, {2, 3, -1} }});
+
+            // degenerate lines.
+            static_assert(line<1>(2, 5, 2, 5) == std::array<Span, 1>{{ {2, 2, 5} }});
+            static_assert(line<1>(7, 1, 2, 1) == std::array<Span, 1>{{ {2, 7, 1} }});
+            static_assert(line<3>(4, 2, 4, 0) == std::array<Span, 3>{{ {4, 4, 2}, {4, 4, 1}, {4, 4, 0} }});
+            static_assert(line<3>(0, 0, 2, 2) == std::array<Span, 3>{{ {0, 0, 0}, {1, 1, 1}, {2, 2, 2} }});
+        } // namespace test::lineSpans_
+    } // namespace internal
+
+
+    /// line.
+    /// bresenham, emitting one span per run of pixels on the same row.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawLine(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x0, utils::isize_t p_y0,
+        utils::isize_t p_x1, utils::isize_t p_y1,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (!boundsInView(
+            p_dst,
+            std::min(p_x0, p_x1), std::min(p_y0, p_y1),
+            std::max(p_x0, p_x1), std::max(p_y0, p_y1)
+        )) { return; }
+
+        internal::lineSpans(p_x0, p_y0, p_x1, p_y1, [&](utils::isize_t p_span_x0, utils::isize_t p_span_x1, utils::isize_t p_y){
+            fillSpanSafe(p_dst, p_span_x0, p_span_x1, p_y, p_value, p_blend);
+        });
+    }
+
+
+    /// rect outline.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawRect(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x, utils::isize_t p_y,
+        utils::isize_t p_w, utils::isize_t p_h,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_w <= 0 || p_h <= 0) { return; }
+
+        const auto x1 = p_x + p_w - 1;
+        const auto y1 = p_y + p_h - 1;
+        if (!boundsInView(p_dst, p_x, p_y, x1, y1)) { return; }
+
+        fillSpanSafe(p_dst, p_x, x1, p_y, p_value, p_blend);
+        for (auto y = p_y + 1; y < y1; ++y)
+        {
+            fillSpanSafe(p_dst, p_x, p_x, y, p_value, p_blend);
+            if (x1 != p_x) { fillSpanSafe(p_dst, x1, x1, y, p_value, p_blend); }
+        }
+        if (y1 != p_y) { fillSpanSafe(p_dst, p_x, x1, y1, p_value, p_blend); }
+    }
+
+
+    /// safe fill rect.
+    /// signed coordinates, clipped to the scissor of p_dst.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillRectSafe(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x, utils::isize_t p_y,
+        utils::isize_t p_w, utils::isize_t p_h,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_w <= 0 || p_h <= 0) { return; }
+        fillRect(p_dst, p_x, p_y, p_w, p_h, p_value, p_blend);
+    }
+
+
+    /// circle outline.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawCircle(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_cx, utils::isize_t p_cy, utils::isize_t p_r,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_r < 0) { return; }
+        if (!boundsInView(p_dst, p_cx - p_r, p_cy - p_r, p_cx + p_r, p_cy + p_r)) { return; }
+
+        internal::circleRows(p_r, [&](utils::isize_t p_dy, utils::isize_t p_lo, utils::isize_t p_hi){
+            for (const auto y : {p_cy - p_dy, p_cy + p_dy})
+            {
+                fillSpanSafe(p_dst, p_cx + p_lo, p_cx + p_hi, y, p_value, p_blend);
+                // lo == 0 means the run crosses the center column, already drawn.
+                fillSpanSafe(p_dst, p_cx - p_hi, p_cx - std::max<utils::isize_t>(p_lo, 1), y, p_value, p_blend);
+                if (p_dy == 0) { break; }
+            }
+        });
+    }
+
+
+    /// filled circle.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillCircle(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_cx, utils::isize_t p_cy, utils::isize_t p_r,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_r < 0) { return; }
+        if (!boundsInView(p_dst, p_cx - p_r, p_cy - p_r, p_cx + p_r, p_cy + p_r)) { return; }
+
+        internal::circleRows(p_r, [&](utils::isize_t p_dy, utils::isize_t, utils::isize_t p_hi){
+            fillSpanSafe(p_dst, p_cx - p_hi, p_cx + p_hi, p_cy - p_dy, p_value, p_blend);
+            if (p_dy != 0) { fillSpanSafe(p_dst, p_cx - p_hi, p_cx + p_hi, p_cy + p_dy, p_value, p_blend); }
+        });
+    }
+
+
+    /// rounded rect outline.
+    /// p_r is clamped to half the smaller side.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawRoundRect(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x, utils::isize_t p_y,
+        utils::isize_t p_w, utils::isize_t p_h,
+        utils::isize_t p_r,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_w <= 0 || p_h <= 0) { return; }
+        if (!boundsInView(p_dst, p_x, p_y, p_x + p_w - 1, p_y + p_h - 1)) { return; }
+
+        const auto r = std::clamp<utils::isize_t>(p_r, 0, (std::min(p_w, p_h) - 1) / 2);
+        if (r == 0)
+        {
+            drawRect(p_dst, p_x, p_y, p_w, p_h, p_value, p_blend);
+            return;
+        }
+
+        // corner circle centers.
+        const auto cx0 = p_x + r;
+        const auto cx1 = p_x + p_w - 1 - r;
+        const auto cy0 = p_y + r;
+        const auto cy1 = p_y + p_h - 1 - r;
+
+        internal::circleRows(r, [&](utils::isize_t p_dy, utils::isize_t p_lo, utils::isize_t p_hi){
+            if (p_dy == 0) { return; }
+            for (const auto y : {cy0 - p_dy, cy1 + p_dy})
+            {
+                // top and bottom edges join the two corners into one span.
+                if (p_lo == 0)
+                {
+                    fillSpanSafe(p_dst, cx0 - p_hi, cx1 + p_hi, y, p_value, p_blend);
+                }
+                else
+                {
+                    fillSpanSafe(p_dst, cx0 - p_hi, cx0 - p_lo, y, p_value, p_blend);
+                    fillSpanSafe(p_dst, cx1 + p_lo, cx1 + p_hi, y, p_value, p_blend);
+                }
+            }
+        });
+
+        for (auto y = cy0; y <= cy1; ++y)
+        {
+            fillSpanSafe(p_dst, p_x, p_x, y, p_value, p_blend);
+            fillSpanSafe(p_dst, p_x + p_w - 1, p_x + p_w - 1, y, p_value, p_blend);
+        }
+    }
+
+
+    /// filled rounded rect.
+    /// p_r is clamped to half the smaller side.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillRoundRect(
+        Image<T_DstFormat> p_dst,
+        utils::isize_t p_x, utils::isize_t p_y,
+        utils::isize_t p_w, utils::isize_t p_h,
+        utils::isize_t p_r,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_w <= 0 || p_h <= 0) { return; }
+        if (!boundsInView(p_dst, p_x, p_y, p_x + p_w - 1, p_y + p_h - 1)) { return; }
+
+        const auto r = std::clamp<utils::isize_t>(p_r, 0, (std::min(p_w, p_h) - 1) / 2);
+
+        const auto cx0 = p_x + r;
+        const auto cx1 = p_x + p_w - 1 - r;
+        const auto cy0 = p_y + r;
+        const auto cy1 = p_y + p_h - 1 - r;
+
+        internal::circleRows(r, [&](utils::isize_t p_dy, utils::isize_t, utils::isize_t p_hi){
+            if (p_dy == 0) { return; }
+            fillSpanSafe(p_dst, cx0 - p_hi, cx1 + p_hi, cy0 - p_dy, p_value, p_blend);
+            fillSpanSafe(p_dst, cx0 - p_hi, cx1 + p_hi, cy1 + p_dy, p_value, p_blend);
+        });
+
+        fillRectSafe(p_dst, p_x, cy0, p_w, cy1 - cy0 + 1, p_value, p_blend);
+    }
+
+
+    namespace internal
+    {
+        /// walks the rows p_y_begin to p_y_end (exclusive) of the polygon p_points.
+        /// scanline edge table sampled at pixel centers, even-odd fill rule.
+        /// calls p_span(x0, x1, y) for every inside run, top to bottom, left to right.
+        /// accepts at most max_polygon_edges non-horizontal edges.
+        template <typename T_SpanFn>
+        constexpr void polygonSpans(
+            std::span<const math::Point<utils::isize_t>> p_points,
+            utils::isize_t p_y_begin, utils::isize_t p_y_end,
+            T_SpanFn&& p_span
+        )
+        {
+            // x positions are 16.16 fixed point.
+            constexpr utils::isize_t frac_bits = 16;
+            constexpr utils::isize_t one = utils::isize_t{1} << frac_bits;
+            constexpr utils::isize_t half = one >> 1;
+
+            struct Edge
+            {
+                utils::isize_t y_top;
+                utils::isize_t y_bot;
+                utils::isize_t x0;
+                utils::isize_t y0;
+                utils::isize_t x;
+                utils::isize_t dx;
+            };
+
+            if (p_points.size() < 3) { return; }
+
+            // edge table, sorted by top row.
+            std::array<Edge, max_polygon_edges> edges;
+            std::size_t num_edges = 0;
+
+            for (std::size_t i = 0; i < p_points.size(); ++i)
+            {
+                auto a = p_points[i];
+                auto b = p_points[(i + 1) % p_points.size()];
+
+                if (a.y == b.y) { continue; }
+                if (a.y > b.y) { std::swap(a, b); }
+
+                assert(num_edges < edges.size());
+                if (num_edges == edges.size()) { break; }
+
+                Edge edge{
+                    .y_top = a.y,
+                    .y_bot = b.y,
+                    .x0 = a.x * one,
+                    .y0 = a.y,
+                    .x = 0,
+                    .dx = (b.x - a.x) * one / (b.y - a.y),
+                };
+
+                auto pos = num_edges++;
+                for (; pos > 0 && edges[pos - 1].y_top > edge.y_top; --pos)
+                {
+                    edges[pos] = edges[pos - 1];
+                }
+                edges[pos] = edge;
+            }
+
+            // active edge table, indices into edges.
+            std::array<std::size_t, max_polygon_edges> active;
+            std::size_t num_active = 0;
+            std::size_t next_edge = 0;
+
+            std::array<utils::isize_t, max_polygon_edges> crossings;
+
+            for (auto y = p_y_begin; y < p_y_end; ++y)
+            {
+                // retire finished edges.
+                std::size_t kept = 0;
+                for (std::size_t i = 0; i < num_active; ++i)
+                {
+                    if (edges[active[i]].y_bot > y) { active[kept++] = active[i]; }
+                }
+                num_active = kept;
+
+                // activate edges reaching this row, positioned at the row center.
+                for (; next_edge < num_edges && edges[next_edge].y_top <= y; ++next_edge)
+                {
+                    auto& edge = edges[next_edge];
+                    if (edge.y_bot <= y) { continue; }
+                    edge.x = edge.x0 + ((2 * (y - edge.y0) + 1) * edge.dx) / 2;
+                    active[num_active++] = next_edge;
+                }
+
+                // sorted crossings.
+                std::size_t num_crossings = 0;
+                for (std::size_t i = 0; i < num_active; ++i)
+                {
+                    auto& edge = edges[active[i]];
+                    auto pos = num_crossings++;
+                    for (; pos > 0 && crossings[pos - 1] > edge.x; --pos)
+                    {
+                        crossings[pos] = crossings[pos - 1];
+                    }
+                    crossings[pos] = edge.x;
+                    edge.x += edge.dx;
+                }
+
+                // pixels whose centers lie in [a, b).
+                for (std::size_t i = 0; i + 1 < num_crossings; i += 2)
+                {
+                    const auto x0 = (crossings[i] - half + one - 1) >> frac_bits;
+                    const auto x1 = ((crossings[i + 1] - half + one - 1) >> frac_bits) - 1;
+                    if (x0 <= x1) { p_span(x0, x1, y); }
+                }
+            }
+        }
+
+        namespace test::polygonSpans_
+        {
+            using Point = math::Point<utils::isize_t>;
+
+            template <std::size_t t_count, std::size_t t_num_points>
+            constexpr auto polygon(const std::array<Point, t_num_points>& p_points, utils::isize_t p_y_begin, utils::isize_t p_y_end)
+            {
+                return collectSpans<t_count>([&](auto p_span){ polygonSpans(p_points, p_y_begin, p_y_end, p_span); });
+            }
+
+            // concave U, the notch splits the lower rows in two.
+            constexpr std::array<Point, 8> u{{ {0, 0}, {6, 0}, {6, 4}, {4, 4}, {4, 2}, {2, 2}, {2, 4}, {0, 4} }};
+            static_assert(polygon<6>(u, 0, 4) == std::array<Span, 6>{{
+                {0, 5, 0}, {0, 5, 1},
+                {0, 1, 2}, {4, 5, 2},
+                {0, 1, 3}, {4, 5, 3},
+            }});
+            // rows outside the range are skipped.
+            static_assert(polygon<2>(u, 3, 4) == std::array<Span, 2>{{ {0, 1, 3}, {4, 5, 3} }});
+
+            // concave V notch with sloped edges.
+            constexpr std::array<Point, 5> v{{ {0, 0}, {4, 2}, {8, 0}, {8, 4}, {0, 4} }};
+            static_assert(polygon<6>(v, 0, 4) == std::array<Span, 6>{{
+                {0, 0, 0}, {7, 7, 0},
+                {0, 2, 1}, {5, 7, 1},
+                {0, 7, 2}, {0, 7, 3},
+            }});
+        } // namespace test::polygonSpans_
+    } // namespace internal
+
+
+    /// filled polygon, convex or concave.
+    /// scanline edge table sampled at pixel centers, even-odd fill rule.
+    /// accepts at most max_polygon_edges non-horizontal edges.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void fillPolygon(
+        Image<T_DstFormat> p_dst,
+        std::span<const math::Point<utils::isize_t>> p_points,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_points.size() < 3) { return; }
+
+        utils::isize_t min_x = p_points[0].x, max_x = p_points[0].x;
+        utils::isize_t min_y = p_points[0].y, max_y = p_points[0].y;
+        for (const auto point : p_points)
+        {
+            min_x = std::min(min_x, point.x);
+            max_x = std::max(max_x, point.x);
+            min_y = std::min(min_y, point.y);
+            max_y = std::max(max_y, point.y);
+        }
+
+        if (!boundsInView(p_dst, min_x, min_y, max_x, max_y)) { return; }
+
+        internal::polygonSpans(
+            p_points,
+            std::max<utils::isize_t>(min_y, p_dst.scissor.position.y),
+            std::min<utils::isize_t>(max_y, p_dst.scissor.end().y),
+            [&](utils::isize_t p_x0, utils::isize_t p_x1, utils::isize_t p_y){
+                fillSpanSafe(p_dst, p_x0, p_x1, p_y, p_value, p_blend);
+            });
+    }
+
+} // namespace picon::graphics::fn
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "color.hpp"
+#include "image.hpp"
+#include "raster.hpp"
+
+#include "math/point.hpp"
+#include "time/time.hpp"
+#include "utils/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <span>
+
+namespace picon::graphics
+{
+
+    namespace internal
+    {
+        /// blend mode that stores like None and counts the spans and pixels it is called for.
+        struct CountSpans
+        {
+            std::size_t* spans;
+            std::size_t* pixels;
+            std::size_t* last_x;
+            std::size_t* last_y;
+
+            template <color::ColorType T_DstFormat, color::ColorType T_SrcFormat>
+            constexpr void operator()(T_DstFormat& r_dst, T_SrcFormat p_src, std::size_t p_x, std::size_t p_y)
+            {
+                r_dst = color::convert<T_DstFormat>(p_src);
+                *spans += p_y != *last_y || p_x != *last_x + 1;
+                ++*pixels;
+                *last_x = p_x;
+                *last_y = p_y;
+            }
+        };
+    } // namespace internal
+
+    /// print the spans and pixels p_draw(frame, blend) fills into a 256x64 frame
+    /// and how many of them the rasterizer emits per second.
+    template <typename T_Draw>
+    void benchmarkRaster(const char* p_name, T_Draw&& p_draw, std::size_t p_num_frames = 256)
+    {
+        using Format = color::R4G4B4A4;
+        const auto frame_data = std::make_unique<ImageData<Format, 256, 64>>();
+        const Image<Format> frame{*frame_data};
+
+        // spans are counted in a separate pass, so the timed one runs the real fill loop.
+        std::size_t spans{};
+        std::size_t pixels{};
+        std::size_t last_x{SIZE_MAX - 1};
+        std::size_t last_y{SIZE_MAX};
+        p_draw(frame, internal::CountSpans{&spans, &pixels, &last_x, &last_y});
+
+        const auto start = time::getEpochTimeUs64();
+        for (std::size_t i = 0; i < p_num_frames; ++i)
+        {
+            p_draw(frame, color::blend::none);
+        }
+        const auto elapsed_us = time::getEpochTimeUs64() - start;
+
+        const auto seconds = static_cast<double>(elapsed_us) / 1'000'000;
+        std::printf("%-16s %8zu spans %8zu px %10.1f us/frame %10.2f Mspans/s %10.2f Mpx/s\n",
+            p_name,
+            spans,
+            pixels,
+            static_cast<double>(elapsed_us) / p_num_frames,
+            elapsed_us > 0 ? spans * p_num_frames / seconds / 1'000'000 : 0.0,
+            elapsed_us > 0 ? pixels * p_num_frames / seconds / 1'000'000 : 0.0);
+    }
+
+    /// every primitive of graphics/raster.hpp at random positions and sizes,
+    /// partly outside the frame so clipping is part of the cost.
+    inline void benchmarkRaster()
+    {
+        using Point = math::Point<utils::isize_t>;
+        constexpr std::size_t num_shapes = 64;
+        constexpr color::GS4 value{0b1010};
+
+        std::minstd_rand random{1};
+        const auto coordinate = [&](utils::isize_t p_min, utils::isize_t p_max){
+            return static_cast<utils::isize_t>(p_min + random() % (p_max - p_min));
+        };
+
+        std::array<std::array<utils::isize_t, 5>, num_shapes> shapes{};
+        for (auto& shape : shapes)
+        {
+            shape = {coordinate(-16, 272), coordinate(-16, 80), coordinate(-16, 272), coordinate(-16, 80), coordinate(2, 24)};
+        }
+
+        // a concave star, 10 points.
+        constexpr std::array<Point, 10> star{{
+            {0, -20}, {6, -6}, {20, -6}, {9, 3}, {13, 18}, {0, 9}, {-13, 18}, {-9, 3}, {-20, -6}, {-6, -6},
+        }};
+
+        benchmarkRaster("drawLine", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::drawLine(p_frame, s[0], s[1], s[2], s[3], value, p_blend); }
+        });
+        benchmarkRaster("drawRect", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::drawRect(p_frame, s[0], s[1], s[4] * 2, s[4], value, p_blend); }
+        });
+        benchmarkRaster("drawCircle", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::drawCircle(p_frame, s[0], s[1], s[4], value, p_blend); }
+        });
+        benchmarkRaster("fillCircle", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::fillCircle(p_frame, s[0], s[1], s[4], value, p_blend); }
+        });
+        benchmarkRaster("drawRoundRect", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::drawRoundRect(p_frame, s[0], s[1], s[4] * 2, s[4], s[4] / 3, value, p_blend); }
+        });
+        benchmarkRaster("fillRoundRect", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes) { fn::fillRoundRect(p_frame, s[0], s[1], s[4] * 2, s[4], s[4] / 3, value, p_blend); }
+        });
+        benchmarkRaster("fillPolygon", [&](auto p_frame, auto p_blend){
+            for (const auto& s : shapes)
+            {
+                std::array<Point, star.size()> points{};
+                for (std::size_t i = 0; i < star.size(); ++i) { points[i] = star[i] + Point{s[0], s[1]}; }
+                fn::fillPolygon(p_frame, std::span<const Point>{points}, value, p_blend);
+            }
+        });
+    }
+
+} // namespace picon::graphics
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "blend.hpp"
+#include "color.hpp"
+#include "font.hpp"
+#include "functions.hpp"
+#include "image.hpp"
+#include "raster.hpp"
+
+#include "math/point.hpp"
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace picon::graphics::fn
+{
+
+    namespace internal
+    {
+        /// lays out p_text with p_font from origin 0, 0 and calls
+        /// p_span(x, y, w) for every horizontal run of set mask bits.
+        /// '\n' starts a new line, codepoints missing from the font are skipped.
+        template <typename T_SpanFn>
+        constexpr void forEachGlyphSpan(const Font& p_font, std::string_view p_text, T_SpanFn&& p_span)
+        {
+            utils::isize_t pen_x = 0;
+            utils::isize_t pen_y = 0;
+
+            for (const unsigned char c : p_text)
+            {
+                if (c == '\n')
+                {
+                    pen_x = 0;
+                    pen_y += p_font.line_height;
+                    continue;
+                }
+
+                const auto glyph = p_font.glyph(c);
+                if (glyph == nullptr) { continue; }
+
+                const auto glyph_x = pen_x + glyph->offset_x;
+                const auto glyph_y = pen_y + glyph->offset_y;
+
+                for (std::size_t y = 0; y < glyph->height; ++y)
+                {
+                    std::size_t x = 0;
+                    while (x < glyph->width)
+                    {
+                        if (!p_font.bit(*glyph, x, y)) { ++x; continue; }
+
+                        const auto run_start = x;
+                        while (x < glyph->width && p_font.bit(*glyph, x, y)) { ++x; }
+                        p_span(glyph_x + run_start, glyph_y + y, x - run_start);
+                    }
+                }
+
+                pen_x += glyph->advance;
+            }
+        }
+
+        /// fnv-1a, length included so prefixes don't collide with empty text.
+        constexpr std::uint32_t hashText(std::string_view p_text)
+        {
+            std::uint32_t hash = 2166136261u ^ static_cast<std::uint32_t>(p_text.size());
+            for (const unsigned char c : p_text)
+            {
+                hash = (hash ^ c) * 16777619u;
+            }
+            return hash;
+        }
+    } // namespace internal
+
+
+    /// pre-laid-out text.
+    /// caches the glyph spans of a string so unchanged labels skip layout
+    /// and mask decoding entirely when drawn.
+    /// the text is kept to tell whether it changed, text longer than
+    /// t_max_text is laid out on every setText.
+    /// @tparam t_max_spans
+    /// @tparam t_max_text
+    template <std::size_t t_max_spans, std::size_t t_max_text = 64>
+    struct TextLabel
+    {
+        struct Span
+        {
+            std::int16_t x;
+            std::int16_t y;
+            std::uint16_t w;
+        };
+
+        std::array<Span, t_max_spans> spans{};
+        std::size_t num_spans{};
+
+        /// bounds of all spans, relative to the draw origin.
+        utils::isize_t min_x{}, min_y{}, max_x{-1}, max_y{-1};
+
+        /// set when the text needed more than t_max_spans spans.
+        bool truncated{};
+
+        const Font* font{};
+        std::uint32_t text_hash{};
+        /// copy of the laid out text, valid if text_size <= t_max_text.
+        std::array<char, t_max_text> text{};
+        std::size_t text_size{SIZE_MAX};
+
+        /// lays out p_text unless it and p_font match the previous call.
+        /// returns true if the layout was rebuilt.
+        constexpr bool setText(const Font& p_font, std::string_view p_text)
+        {
+            // the hash rejects most changes without touching the copy.
+            const auto hash = internal::hashText(p_text);
+            if (font == &p_font &&
+                text_hash == hash &&
+                text_size == p_text.size() &&
+                std::string_view{text.data(), text_size} == p_text)
+            {
+                return false;
+            }
+
+            font = &p_font;
+            text_hash = hash;
+            if (p_text.size() <= t_max_text)
+            {
+                std::copy(p_text.begin(), p_text.end(), text.begin());
+                text_size = p_text.size();
+            }
+            else
+            {
+                text_size = SIZE_MAX;
+            }
+            num_spans = 0;
+            truncated = false;
+            min_x = min_y = 0;
+            max_x = max_y = -1;
+
+            internal::forEachGlyphSpan(p_font, p_text, [&](utils::isize_t p_x, utils::isize_t p_y, std::size_t p_w){
+                if (num_spans == spans.size()) { truncated = true; return; }
+
+                const auto x1 = p_x + static_cast<utils::isize_t>(p_w) - 1;
+                if (num_spans == 0)
+                {
+                    min_x = p_x; min_y = p_y; max_x = x1; max_y = p_y;
+                }
+                else
+                {
+                    min_x = std::min(min_x, p_x);
+                    min_y = std::min(min_y, p_y);
+                    max_x = std::max(max_x, x1);
+                    max_y = std::max(max_y, p_y);
+                }
+
+                spans[num_spans++] = {
+                    static_cast<std::int16_t>(p_x),
+                    static_cast<std::int16_t>(p_y),
+                    static_cast<std::uint16_t>(p_w),
+                };
+            });
+
+            return true;
+        }
+    };
+
+    namespace internal::test::TextLabel_
+    {
+        constexpr Glyph glyph{0, 0, 1, 1, 0, 0, 2};
+        constexpr std::array<std::uint8_t, 1> atlas{0x80};
+        constexpr Font font{1, atlas, std::span<const Glyph>{&glyph, 1}, 'A', 2, 1};
+
+        /// whether the second setText rebuilt the layout.
+        template <std::size_t t_max_text>
+        constexpr bool relaid(std::string_view p_first, std::string_view p_second)
+        {
+            TextLabel<8, t_max_text> label{};
+            label.setText(font, p_first);
+            return label.setText(font, p_second);
+        }
+
+        static_assert(!relaid<8>("AA", "AA"));
+        static_assert(relaid<8>("AA", "A"));
+        static_assert(relaid<8>("A", "AB"));
+        static_assert(relaid<8>("AB", "BA"));
+        // same length and same hash, told apart by the copy.
+        static_assert(hashText("03rJU") == hashText("0A1aA"));
+        static_assert(relaid<8>("03rJU", "0A1aA"));
+        // too long to keep a copy of, always laid out again.
+        static_assert(relaid<1>("AA", "AA"));
+    } // namespace internal::test::TextLabel_
+
+
+    /// draw a pre-laid-out label.
+    /// one bounds test, then spans are filled unclipped when fully in view.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        std::size_t t_max_spans,
+        std::size_t t_max_text,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawText(
+        Image<T_DstFormat> p_dst, utils::isize_t p_dst_x, utils::isize_t p_dst_y,
+        const TextLabel<t_max_spans, t_max_text>& p_label,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        if (p_label.num_spans == 0) { return; }
+
+        const auto x0 = p_dst_x + p_label.min_x;
+        const auto y0 = p_dst_y + p_label.min_y;
+        const auto x1 = p_dst_x + p_label.max_x;
+        const auto y1 = p_dst_y + p_label.max_y;
+        if (!boundsInView(p_dst, x0, y0, x1, y1)) { return; }
+
+        const bool inside = p_dst.scissor.contains({{x0, y0}, {x1 - x0 + 1, y1 - y0 + 1}});
+
+        for (std::size_t i = 0; i < p_label.num_spans; ++i)
+        {
+            const auto& span = p_label.spans[i];
+            if (inside)
+            {
+                internal::fillSpanUnclipped(p_dst, p_dst_x + span.x, p_dst_y + span.y, span.w, p_value, p_blend);
+            }
+            else
+            {
+                fillSpanSafe(p_dst, p_dst_x + span.x, p_dst_x + span.x + span.w - 1, p_dst_y + span.y, p_value, p_blend);
+            }
+        }
+    }
+
+
+    /// draw text without a cached layout.
+    /// decodes glyph masks on every call, prefer TextLabel for text drawn each frame.
+    template <
+        color::ColorType T_DstFormat,
+        color::ColorType T_SrcFormat,
+        color::blend::BlendMode<T_DstFormat, T_SrcFormat> T_Blend=color::blend::None
+    >
+    inline void drawText(
+        Image<T_DstFormat> p_dst, utils::isize_t p_dst_x, utils::isize_t p_dst_y,
+        const Font& p_font, std::string_view p_text,
+        T_SrcFormat p_value,
+        T_Blend p_blend = {}
+    )
+    {
+        internal::forEachGlyphSpan(p_font, p_text, [&](utils::isize_t p_x, utils::isize_t p_y, std::size_t p_w){
+            fillSpanSafe(p_dst, p_dst_x + p_x, p_dst_x + p_x + p_w - 1, p_dst_y + p_y, p_value, p_blend);
+        });
+    }
+
+
+    /// size in pixels of p_text laid out with p_font.
+    /// width is the furthest pen advance, height is line_height per line.
+    constexpr math::Point<utils::isize_t> measureText(const Font& p_font, std::string_view p_text)
+    {
+        utils::isize_t pen_x = 0;
+        utils::isize_t width = 0;
+        utils::isize_t lines = p_text.empty() ? 0 : 1;
+
+        for (const unsigned char c : p_text)
+        {
+            if (c == '\n')
+            {
+                pen_x = 0;
+                ++lines;
+                continue;
+            }
+            if (const auto glyph = p_font.glyph(c)) { pen_x += glyph->advance; }
+            width = std::max(width, pen_x);
+        }
+
+        return {width, lines * p_font.line_height};
+    }
+
+} // namespace picon::graphics::fn
\ No newline at end of file
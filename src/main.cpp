@@ -2,26 +2,66 @@
 
 #include "assets/images.hpp"
 
+#include "async/runtime.hpp"
+#include "async/task.hpp"
+
 #include "graphics/color.hpp"
+#include "graphics/draw_list.hpp"
 #include "graphics/functions.hpp"
 #include "graphics/image.hpp"
+#include "graphics/particles.hpp"
+#include "math/fixed.hpp"
+#include "memory/arena.hpp"
+#include "time/pacer.hpp"
+#include "time/scheduler.hpp"
 #include "time/time.hpp"
+#include "utils/types.hpp"
 
-#include <cmath>
+#include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <random>
 #include <ratio>
 
 
 #if defined(PICON_PLATFORM_PICO)
 #include "drivers/sh1122.hpp"
+#include "drivers/sh1122_pio.hpp"
 #include "pal/pico/pico.hpp"
 #include <pico/stdio.h>
 #endif // defined(PICON_PLATFORM_PICO)
 
+#if defined(PICON_CONVERT_BENCHMARK)
+#include "graphics/convert_benchmark.hpp"
+#endif // defined(PICON_CONVERT_BENCHMARK)
+
+#if defined(PICON_FIXED_BENCHMARK)
+#include "math/fixed_benchmark.hpp"
+#endif // defined(PICON_FIXED_BENCHMARK)
+
+#if defined(PICON_PARTICLES_BENCHMARK)
+#include "graphics/particles_benchmark.hpp"
+#endif // defined(PICON_PARTICLES_BENCHMARK)
+
+#if defined(PICON_PIPE_BENCHMARK)
+#include "graphics/pipe_benchmark.hpp"
+#endif // defined(PICON_PIPE_BENCHMARK)
+
+#if defined(PICON_RASTER_BENCHMARK)
+#include "graphics/raster_benchmark.hpp"
+#endif // defined(PICON_RASTER_BENCHMARK)
+
+#if defined(PICON_PERF_HUD)
+#include "graphics/hud.hpp"
+#endif // defined(PICON_PERF_HUD)
+
 #if defined(PICON_PLATFORM_LINUX)
 #include "drivers/sdl.hpp"
+#include "drivers/shm.hpp"
 #include <SDL3/SDL_events.h>
-#include <SDL3/SDL_timer.h>
+#include <SDL3/SDL_keycode.h>
+#include <atomic>
+#include <thread>
 #endif // defined(PICON_PLATFORM_LINUX)
 
 using namespace picon;
@@ -30,15 +70,24 @@ using namespace picon;
 drivers::SH1122Driver<
     256,  // t_width
     64,   // t_height
-    18,   // t_sck
-    19,   // t_mosi
-    16,   // t_dc
-    17,   // t_cs
-    20    // t_rst
-> display{.pio = pio0};
+    drivers::SH1122PioTransport<
+        18,   // t_sck
+        19,   // t_mosi
+        16,   // t_dc
+        17,   // t_cs
+        20    // t_rst
+    >
+> display{.transport = {.pio = pio0}};
 #endif // defined(PICON_PLATFORM_PICO)
 
-#if defined(PICON_PLATFORM_LINUX)
+#if defined(PICON_PLATFORM_LINUX) && defined(PICON_SHM_DISPLAY)
+/// headless, frames go to /dev/shm/picon, or PICON_SHM, for picon_shm_viewer and other readers.
+drivers::ShmDriver<
+    graphics::color::R4G4B4A4,  // T_Color
+    256,                        // t_width
+    64                          // t_height
+> display{};
+#elif defined(PICON_PLATFORM_LINUX)
 drivers::SdlDriver<
     // graphics::color::GS4,       // T_Color
     // graphics::color::R8G8B8,    // T_Color
@@ -46,47 +95,58 @@ drivers::SdlDriver<
     256,                        // t_width
     64                          // t_height
 > display{.integer_scaling = true};
+#endif
+
+#if defined(PICON_PLATFORM_LINUX)
+/// set PICON_CAPTURE to a path to record every presented frame.
+decltype(display)::Capture capture{};
 #endif // defined(PICON_PLATFORM_LINUX)
 
+async::Runtime runtime{};
+
 constexpr auto bg = assets::images::bg;
 constexpr auto heart = assets::images::heart;
 
+/// the frame's draws, rendered with the pixels hidden under the opaque bg skipped.
+graphics::DrawList<decltype(display)::FrameBuffer::Format, 384> draw_list{};
+
 constexpr std::size_t fb_width = decltype(display)::width;
 constexpr std::size_t fb_height = decltype(display)::height;
 
-std::float_t bg_offset_x{ 0 };
-std::float_t bg_offset_y{ 0 };
-constexpr std::float_t bg_speed_x{1.0 * fb_width / std::micro::den / 8};
-constexpr std::float_t bg_speed_y{1.0 * fb_height / std::micro::den / 8};
-
+/// positions in pixels, speeds in pixels per second. fixed point, the rp2040 has no fpu.
+using Unit = math::Fixed<15, 16>;
 
-constexpr auto num_heart_cols = 16;
-constexpr auto num_heart_rows = 16;
+Unit bg_offset_x{ 0 };
+Unit bg_offset_y{ 0 };
+constexpr Unit bg_speed_x{Unit{fb_width} / 8};
+constexpr Unit bg_speed_y{Unit{fb_height} / 8};
 
-std::float_t heart_offset_x{ 1.0 * heart.width * -num_heart_cols };
-std::float_t heart_offset_y{ 1.0 * heart.height * -num_heart_rows };
-constexpr std::float_t heart_speed_x{(1.0 * fb_width + heart.width * num_heart_cols) / std::micro::den / 2};
-constexpr std::float_t heart_speed_y{(1.0 * fb_height + heart.height * num_heart_rows) / std::micro::den / 8};
 
-// constexpr auto num_heart_cols = 1;
-// constexpr auto num_heart_rows = 480;
-// constexpr auto num_heart_rows = 240;
+/// hearts streaming in from the left edge.
+graphics::ParticleSystem<512> hearts{};
+std::minstd_rand heart_random{};
+Unit heart_spawns{ 0 };
+constexpr Unit hearts_per_second{ 96 };
+constexpr std::int32_t heart_lifetime_us{ 4 * std::micro::den };
+constexpr Unit heart_speed_x{ Unit{fb_width + heart.width} / 2 };
+constexpr Unit heart_speed_y{ Unit{fb_height} / 8 };
 
-// std::float_t heart_offset_x{ -1.0 * blit_image1.width };
-// std::float_t heart_offset_y{ -1.0 * blit_image1.height };
-// constexpr std::float_t heart_speed_x{(256.0 + blit_image1.width) / std::micro::den / 2};
-// constexpr std::float_t heart_speed_y{(64.0 + blit_image1.height) / std::micro::den / 8};
+#if defined(PICON_PERF_HUD)
+graphics::PerfHud<> hud{};
+#endif // defined(PICON_PERF_HUD)
 
 
 void displayTick(std::uint64_t p_delta)
 {
-    auto fb = display.getBackBuffer();
+    draw_list.begin(display.getBackBuffer());
 
-    // graphics::fn::fill(fb, graphics::color::R5G6B5{0, 0, 0});
-    graphics::fn::fill(fb, graphics::color::R4G4B4A4{0, 0, 0, 0});
+    // draw_list.fill(graphics::color::R5G6B5{0, 0, 0});
+    draw_list.fill(graphics::color::R4G4B4A4{0, 0, 0, 0});
 
-    bg_offset_x += p_delta * bg_speed_x;
-    bg_offset_y += p_delta * bg_speed_y;
+    const auto delta = Unit::fromRatio(p_delta, std::micro::den);
+
+    bg_offset_x += delta * bg_speed_x;
+    bg_offset_y += delta * bg_speed_y;
     if (bg_offset_x > fb_width)
     {
         bg_offset_x = 0;
@@ -97,61 +157,106 @@ void displayTick(std::uint64_t p_delta)
         bg_offset_y = 0;
     }
     
-    std::int64_t bg_x = bg_offset_x;
-    std::int64_t bg_y = bg_offset_y;
-
-    graphics::fn::blitSafe(fb, bg_x - bg.width * 1, bg_y - bg.height * 1, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 0, bg_y - bg.height * 1, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 1, bg_y - bg.height * 1, bg);
+    const auto bg_x = static_cast<utils::isize_t>(bg_offset_x);
+    const auto bg_y = static_cast<utils::isize_t>(bg_offset_y);
 
-    graphics::fn::blitSafe(fb, bg_x - bg.width * 1, bg_y + bg.height * 0, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 0, bg_y + bg.height * 0, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 1, bg_y + bg.height * 0, bg);
+    draw_list.blit(bg_x - bg.width * 1, bg_y - bg.height * 1, bg);
+    draw_list.blit(bg_x + bg.width * 0, bg_y - bg.height * 1, bg);
+    draw_list.blit(bg_x + bg.width * 1, bg_y - bg.height * 1, bg);
 
-    graphics::fn::blitSafe(fb, bg_x - bg.width * 1, bg_y + bg.height * 1, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 0, bg_y + bg.height * 1, bg);
-    graphics::fn::blitSafe(fb, bg_x + bg.width * 1, bg_y + bg.height * 1, bg);
+    draw_list.blit(bg_x - bg.width * 1, bg_y + bg.height * 0, bg);
+    draw_list.blit(bg_x + bg.width * 0, bg_y + bg.height * 0, bg);
+    draw_list.blit(bg_x + bg.width * 1, bg_y + bg.height * 0, bg);
 
+    draw_list.blit(bg_x - bg.width * 1, bg_y + bg.height * 1, bg);
+    draw_list.blit(bg_x + bg.width * 0, bg_y + bg.height * 1, bg);
+    draw_list.blit(bg_x + bg.width * 1, bg_y + bg.height * 1, bg);
 
-    std::int16_t heart_x = heart_offset_x;
-    std::int16_t heart_y = heart_offset_y;
 
-    heart_offset_x += p_delta * heart_speed_x;
-    heart_offset_y += p_delta * heart_speed_y;
-    if (heart_offset_x > fb_width)
+    heart_spawns += delta * hearts_per_second;
+    for (; heart_spawns >= 1; heart_spawns -= 1)
     {
-        heart_offset_x = 1.0 * heart.width * -num_heart_cols;
-        // heart_offset_x = -1.0 * blit_image1.width;
+        const auto speed = heart_speed_x + static_cast<Unit>(heart_random() % fb_width) / 2;
+        hearts.spawn(
+            {-static_cast<Unit>(heart.width), static_cast<Unit>(heart_random() % (fb_height + heart.height))},
+            {speed, heart_speed_y - static_cast<Unit>(heart_random() % fb_height) / 4},
+            heart_lifetime_us,
+            0);
     }
+    hearts.update(p_delta);
+
+    draw_list.fillRect(120 + 16, 24, 16, 16, graphics::color::GS4{0b0010});
+    // draw_list.fillRect(120 + 16, 24, 16, 16, graphics::color::R5G5B5A1{15, 15, 15, 1});
+    // draw_list.fillRect(120 + 16, 24, 16, 16, graphics::color::R5G5B5A1{31, 0, 0, 1});
+    draw_list.flush();
+
+    // blended over the flushed background, the particles bring their own clipping.
+    hearts.draw(display.getBackBuffer(), 0, heart, graphics::color::blend::alpha);
+
+    #if defined(PICON_PERF_HUD)
+    hud.endRender();
+    hud.draw(display.getBackBuffer(), graphics::color::GS4{0b1111}, graphics::color::GS4{0b0000});
+    #endif
+
+    display.swapBuffers();
+}
 
-    if (heart_offset_y > fb_height)
+async::Task<> displayLoop()
+{
+    while (true)
     {
-        heart_offset_y = 1.0 * heart.height * -num_heart_rows;
-        // heart_offset_y = -1.0 * blit_image1.height;
+        const auto delta = co_await async::nextFrame();
+        #if defined(PICON_PERF_HUD)
+        hud.beginFrame();
+        #endif
+        memory::frame_arena.reset();
+        displayTick(delta);
+        co_await async::transferDone(display);
+        #if defined(PICON_PERF_HUD)
+        hud.endTransfer();
+        #endif
     }
+}
 
-    for (auto n = 0; n < 1; ++n)
+/// one pass of the main loop, false once the window was closed.
+bool step(time::Scheduler<1>& r_scheduler, time::FramePacer& r_frame_pacer)
+{
+    #if defined(PICON_PLATFORM_LINUX) && !defined(PICON_SHM_DISPLAY)
+    SDL_Event event;
+    while (display.pollEvent(&event))
     {
-        for (auto i = 0; i < num_heart_cols; ++i)
+        if (event.type == SDL_EVENT_QUIT)
         {
-            for (auto j = 0; j < num_heart_rows; ++j)
-            {
-                graphics::fn::blitSafe(
-                    fb,
-                    heart_x + static_cast<std::int16_t>(i * heart.width),
-                    heart_y + static_cast<std::int16_t>(j * heart.height),
-                    // heart_x,
-                    // heart_y,
-                    heart,
-                    graphics::color::blend::alpha);
-            }
+            return false;
         }
+
+        #if defined(PICON_PERF_HUD)
+        // F1 toggles the performance hud.
+        if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F1)
+        {
+            hud.visible = !hud.visible;
+        }
+        #endif
+
+        #if defined(PICON_GRAPHICS_INSTRUMENT)
+        // F2 toggles the overdraw heatmap, F3 prints the kernel counters since the last F3.
+        if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F2)
+        {
+            display.show_overdraw = !display.show_overdraw;
+        }
+        if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F3)
+        {
+            graphics::instrument::printKernels();
+            graphics::instrument::resetKernels();
+        }
+        #endif
     }
-    
-    graphics::fn::fillRect(fb, 120 + 16, 24, 16, 16, graphics::color::GS4{0b0010});
-    // graphics::fn::fillRect(fb, 120 + 16, 24, 16, 16, graphics::color::R5G5B5A1{15, 15, 15, 1});
-    // graphics::fn::fillRect(fb, 120 + 16, 24, 16, 16, graphics::color::R5G5B5A1{31, 0, 0, 1});
-    display.swapBuffers();
+    #endif
+
+    r_scheduler.run();
+    runtime.run();
+    r_frame_pacer.sleepUntilUs(std::min(r_scheduler.getNextDueUs(), runtime.getNextWakeUs()));
+    return true;
 }
 
 int main()
@@ -166,40 +271,84 @@ int main()
     #elif defined(PICON_PLATFORM_LINUX)
     #endif
 
-    display.init();
+    #if defined(PICON_CONVERT_BENCHMARK)
+    graphics::color::benchmarkConverts();
+    #endif
 
-    // time::DeltaTimer display_timer{std::micro::den / 60};
-    time::DeltaTimer display_timer{std::micro::den / 120};
-    // time::DeltaTimer display_timer{std::micro::den / 15};
+    #if defined(PICON_FIXED_BENCHMARK)
+    math::benchmarkMotions();
+    #endif
 
-    while (true)
+    #if defined(PICON_PARTICLES_BENCHMARK)
+    graphics::benchmarkParticles();
+    #endif
+
+    #if defined(PICON_PIPE_BENCHMARK)
+    graphics::benchmarkPipe();
+    #endif
+
+    #if defined(PICON_RASTER_BENCHMARK)
+    graphics::benchmarkRaster();
+    #endif
+
+    #if defined(PICON_PLATFORM_LINUX)
+    if (const auto capture_path = std::getenv("PICON_CAPTURE"); capture_path != nullptr && capture.open(capture_path))
     {
+        display.capture = &capture;
+    }
+    #endif
 
-        #if defined(PICON_PLATFORM_LINUX)
-        SDL_Event event;
-        while (SDL_PollEvent(&event))
-        {
-            if (event.type == SDL_EVENT_QUIT)
-            {
-                return 0;
-            }
-        }
-        #endif
+    #if defined(PICON_PLATFORM_LINUX) && defined(PICON_SHM_DISPLAY)
+    if (const auto shm_name = std::getenv("PICON_SHM"); shm_name != nullptr)
+    {
+        display.name = shm_name;
+    }
+    #endif
 
-        display_timer.tick();
-        while (display_timer.step())
-        {
-            displayTick(display_timer.getDelta());
-        }
-        
-        #if defined (PICON_PLATFORM_PICO)
-        tight_loop_contents();
+    #if defined(PICON_PLATFORM_LINUX) && !defined(PICON_SHM_DISPLAY)
+    // set PICON_RENDER_THREAD to rasterize on a worker, the main thread then only presents.
+    if (std::getenv("PICON_RENDER_THREAD") != nullptr)
+    {
+        display.use_render_thread = true;
+        display.stats_log_interval_us = 5 * std::micro::den;
+    }
+    #endif
 
-        #elif defined (PICON_PLATFORM_LINUX)
-        SDL_Delay(std::max(display_timer.getDeltaLeft() / 1'000, 20uz) - 20);
+    async::bindTransferDone(runtime, display);
+    display.init();
 
-        #endif
+    time::Scheduler<1> scheduler{};
+    time::FramePacer frame_pacer{};
+
+    #if defined(PICON_PERF_HUD)
+    hud.pacer = &frame_pacer;
+    #endif
+
+    runtime.spawn(displayLoop());
+
+    auto display_task = [](std::uint64_t p_delta){ runtime.frame(p_delta); };
+    // scheduler.addTask(std::micro::den / 60, time::TaskMode::variable, display_task);
+    scheduler.addTask(std::micro::den / 120, time::TaskMode::variable, display_task);
+    // scheduler.addTask(std::micro::den / 15, time::TaskMode::variable, display_task);
+
+    #if defined(PICON_PLATFORM_LINUX) && !defined(PICON_SHM_DISPLAY)
+    if (display.use_render_thread)
+    {
+        std::atomic<bool> rendering{true};
+        std::thread render_thread{[&](){
+            while (step(scheduler, frame_pacer)) {}
+            rendering.store(false, std::memory_order_release);
+        }};
+
+        while (rendering.load(std::memory_order_acquire))
+        {
+            display.presentLatest();
+        }
+        render_thread.join();
+        return 0;
     }
-    
-}
+    #endif
 
+    while (step(scheduler, frame_pacer)) {}
+    return 0;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(PICON_PLATFORM_PICO)
+#include <hardware/divider.h>
+#endif
+
+namespace picon::math
+{
+
+    /// what fixed point arithmetic does with results out of range.
+    enum class Overflow : std::uint8_t
+    {
+        /// two's complement wrap around, like integers.
+        wrap,
+        /// clamp to the smallest or largest value.
+        saturate,
+    };
+
+
+    namespace internal
+    {
+        template <std::size_t t_bits>
+        using FixedValue =
+            std::conditional_t<t_bits <= 8, std::int8_t,
+            std::conditional_t<t_bits <= 16, std::int16_t,
+            std::int32_t>>;
+
+        /// wide enough for the product of two t_bits values.
+        template <std::size_t t_bits>
+        using FixedWide = std::conditional_t<t_bits <= 16, std::int32_t, std::int64_t>;
+
+        /// p_num / p_den, through the hardware divider on the pico when both fit 32 bits.
+        template <std::signed_integral T_Wide>
+        constexpr T_Wide divide(T_Wide p_num, T_Wide p_den)
+        {
+            #if defined(PICON_PLATFORM_PICO)
+            if !consteval
+            {
+                if (p_num >= INT32_MIN && p_num <= INT32_MAX && p_den >= INT32_MIN && p_den <= INT32_MAX)
+                {
+                    return hw_divider_quotient_s32(static_cast<std::int32_t>(p_num), static_cast<std::int32_t>(p_den));
+                }
+            }
+            #endif
+            return p_num / p_den;
+        }
+    } // namespace internal
+
+
+    /// signed fixed point number for math without an fpu.
+    /// usable as the T_Unit of Point and Rect, and mixes with integers, which convert implicitly.
+    /// @tparam t_int_bits integer bits, not counting the sign
+    /// @tparam t_frac_bits fraction bits
+    /// @tparam t_overflow
+    template <std::size_t t_int_bits, std::size_t t_frac_bits, Overflow t_overflow = Overflow::wrap>
+    requires(1 + t_int_bits + t_frac_bits <= 32)
+    struct Fixed
+    {
+        constexpr static std::size_t int_bits = t_int_bits;
+        constexpr static std::size_t frac_bits = t_frac_bits;
+        constexpr static std::size_t num_bits = 1 + t_int_bits + t_frac_bits;
+        constexpr static Overflow overflow = t_overflow;
+
+        using Value = internal::FixedValue<num_bits>;
+        using Wide = internal::FixedWide<num_bits>;
+
+        constexpr static Wide min_raw = -(Wide{1} << (num_bits - 1));
+        constexpr static Wide max_raw = (Wide{1} << (num_bits - 1)) - 1;
+        constexpr static Wide one_raw = Wide{1} << t_frac_bits;
+
+        Value raw{};
+
+        constexpr Fixed() = default;
+
+        constexpr Fixed(std::integral auto p_value) :
+            raw{fromInteger(p_value)}
+        {}
+
+        /// rounds to nearest and saturates, for constants. floats are slow on the pico.
+        constexpr explicit Fixed(std::floating_point auto p_value) :
+            raw{fromWide(fromFloat(p_value))}
+        {}
+
+        constexpr static Fixed fromRaw(Wide p_raw)
+        {
+            Fixed result{};
+            result.raw = fromWide(p_raw);
+            return result;
+        }
+
+        /// p_num / p_den without going through a float, e.g. a time delta in seconds.
+        /// saturates.
+        constexpr static Fixed fromRatio(std::int64_t p_num, std::int64_t p_den)
+        {
+            if (p_den == 0) { return fromRaw(p_num < 0 ? min_raw : max_raw); }
+            return fromRaw(saturate(internal::divide<std::int64_t>(p_num * one_raw, p_den)));
+        }
+
+        /// rounds towards negative infinity.
+        constexpr explicit operator utils::isize_t() const
+        {
+            return raw >> t_frac_bits;
+        }
+
+        constexpr utils::isize_t floor() const
+        {
+            return raw >> t_frac_bits;
+        }
+
+        constexpr utils::isize_t round() const
+        {
+            return (Wide{raw} + (one_raw >> 1)) >> t_frac_bits;
+        }
+
+        template <std::floating_point T_Float>
+        constexpr explicit operator T_Float() const
+        {
+            return static_cast<T_Float>(raw) / one_raw;
+        }
+
+        friend constexpr Fixed operator+(Fixed p_lhs, Fixed p_rhs) { return fromRaw(Wide{p_lhs.raw} + p_rhs.raw); }
+        friend constexpr Fixed operator-(Fixed p_lhs, Fixed p_rhs) { return fromRaw(Wide{p_lhs.raw} - p_rhs.raw); }
+        friend constexpr Fixed operator-(Fixed p_value) { return fromRaw(-Wide{p_value.raw}); }
+
+        friend constexpr Fixed operator*(Fixed p_lhs, Fixed p_rhs)
+        {
+            return fromRaw((Wide{p_lhs.raw} * p_rhs.raw) >> t_frac_bits);
+        }
+
+        /// division by zero gives the largest value of the sign of p_lhs.
+        friend constexpr Fixed operator/(Fixed p_lhs, Fixed p_rhs)
+        {
+            if (p_rhs.raw == 0) { return fromRaw(p_lhs.raw < 0 ? min_raw : max_raw); }
+            return fromRaw(internal::divide<Wide>(Wide{p_lhs.raw} * one_raw, p_rhs.raw));
+        }
+
+        constexpr Fixed& operator+=(Fixed p_rhs) { return *this = *this + p_rhs; }
+        constexpr Fixed& operator-=(Fixed p_rhs) { return *this = *this - p_rhs; }
+        constexpr Fixed& operator*=(Fixed p_rhs) { return *this = *this * p_rhs; }
+        constexpr Fixed& operator/=(Fixed p_rhs) { return *this = *this / p_rhs; }
+
+        friend constexpr bool operator==(Fixed p_lhs, Fixed p_rhs) { return p_lhs.raw == p_rhs.raw; }
+        friend constexpr std::strong_ordering operator<=>(Fixed p_lhs, Fixed p_rhs) { return p_lhs.raw <=> p_rhs.raw; }
+
+    private:
+        constexpr static Wide saturate(std::int64_t p_raw)
+        {
+            return static_cast<Wide>(std::clamp<std::int64_t>(p_raw, min_raw, max_raw));
+        }
+
+        /// rounded and clamped to the raw range. compared in the float's own type
+        /// before converting, where max_raw may round up to one past it.
+        constexpr static Wide fromFloat(std::floating_point auto p_value)
+        {
+            const auto scaled = p_value * one_raw + (p_value < 0 ? -0.5 : 0.5);
+            using Float = decltype(scaled);
+            if (scaled >= static_cast<Float>(max_raw)) { return max_raw; }
+            if (scaled <= static_cast<Float>(min_raw)) { return min_raw; }
+            return static_cast<Wide>(scaled);
+        }
+
+        constexpr static Value fromInteger(std::integral auto p_value)
+        {
+            if constexpr (t_overflow == Overflow::saturate)
+            {
+                return static_cast<Value>(std::clamp<std::intmax_t>(p_value, min_raw >> t_frac_bits, max_raw >> t_frac_bits) << t_frac_bits);
+            }
+            else
+            {
+                return fromWide(static_cast<Wide>(static_cast<std::make_unsigned_t<Wide>>(p_value) << t_frac_bits));
+            }
+        }
+
+        constexpr static Value fromWide(Wide p_raw)
+        {
+            if constexpr (t_overflow == Overflow::saturate)
+            {
+                return static_cast<Value>(saturate(p_raw));
+            }
+            else
+            {
+                // sign extend from num_bits.
+                using Unsigned = std::make_unsigned_t<Wide>;
+                constexpr auto shift = sizeof(Wide) * 8 - num_bits;
+                return static_cast<Value>(static_cast<Wide>(static_cast<Unsigned>(p_raw) << shift) >> shift);
+            }
+        }
+    };
+
+    static_assert(sizeof(Fixed<15, 16>) == 4);
+    static_assert(sizeof(Fixed<7, 8>) == 2);
+
+    static_assert(Fixed<15, 16>{3} + 2 == 5);
+    static_assert(Fixed<15, 16>{1.5} * Fixed<15, 16>{-2.25} == Fixed<15, 16>{-3.375});
+    static_assert(Fixed<15, 16>{7} / 2 == Fixed<15, 16>{3.5});
+    static_assert(Fixed<15, 16>{1} / 0 == Fixed<15, 16>::fromRaw(Fixed<15, 16>::max_raw));
+    static_assert(Fixed<15, 16>::fromRatio(8333, 1'000'000) == Fixed<15, 16>::fromRaw(546));
+    static_assert(static_cast<utils::isize_t>(Fixed<15, 16>{-0.5}) == -1);
+    static_assert(Fixed<15, 16>{2.5}.round() == 3);
+    static_assert(Fixed<15, 16>{-2.5}.round() == -2);
+    // float constants out of range saturate in either overflow mode.
+    static_assert(Fixed<15, 16>{40000.0f} == Fixed<15, 16>::fromRaw(Fixed<15, 16>::max_raw));
+    static_assert(Fixed<15, 16>{-40000.0f} == Fixed<15, 16>::fromRaw(Fixed<15, 16>::min_raw));
+    static_assert(Fixed<15, 16, Overflow::saturate>{1e12} == Fixed<15, 16, Overflow::saturate>::fromRaw(INT32_MAX));
+    static_assert(Fixed<7, 8>{200.0f} == Fixed<7, 8>::fromRaw(INT16_MAX));
+
+    // 7.8 holds -128 to just under 128.
+    static_assert(Fixed<7, 8>{100} + 100 == -56);
+    static_assert(Fixed<7, 8, Overflow::saturate>{100} + 100 == Fixed<7, 8, Overflow::saturate>::fromRaw(INT16_MAX));
+    static_assert(Fixed<7, 8, Overflow::saturate>{-100} * 2 == -128);
+    static_assert(Fixed<7, 8, Overflow::saturate>{1000} == 127);
+
+} // namespace picon::math
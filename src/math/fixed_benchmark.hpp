@@ -0,0 +1,77 @@
+#pragma once
+
+#include "fixed.hpp"
+#include "point.hpp"
+
+#include "time/time.hpp"
+#include "utils/benchmark.hpp"
+#include "utils/types.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ratio>
+
+namespace picon::math
+{
+
+    /// print the cost of one position update in T_Unit, the way main animates:
+    /// move by velocity times the frame delta, wrap at the screen edge and
+    /// convert to integer blit coordinates.
+    template <typename T_Unit>
+    void benchmarkMotion(const char* p_name, std::size_t p_num_objects = 4096, std::size_t p_num_frames = 64)
+    {
+        struct Object
+        {
+            Point<T_Unit> position;
+            Point<T_Unit> velocity;
+        };
+
+        const auto objects = std::make_unique<Object[]>(p_num_objects);
+        for (std::size_t i = 0; i < p_num_objects; ++i)
+        {
+            objects[i].position = {static_cast<T_Unit>(i % 256), static_cast<T_Unit>(i % 64)};
+            objects[i].velocity = {static_cast<T_Unit>(8 + i % 32), static_cast<T_Unit>(4 + i % 16)};
+        }
+
+        const T_Unit width = 256;
+        const T_Unit height = 64;
+        utils::isize_t accumulator{};
+
+        const auto start = time::getEpochTimeUs64();
+        for (std::size_t frame = 0; frame < p_num_frames; ++frame)
+        {
+            // 120 fps with a little jitter.
+            const std::uint64_t delta_us = 8333 + frame % 7;
+            const auto delta = [&](){
+                if constexpr (std::floating_point<T_Unit>) { return static_cast<T_Unit>(delta_us) / std::micro::den; }
+                else { return T_Unit::fromRatio(delta_us, std::micro::den); }
+            }();
+
+            for (std::size_t i = 0; i < p_num_objects; ++i)
+            {
+                auto& object = objects[i];
+                object.position = object.position + object.velocity * delta;
+                if (object.position.x > width) { object.position.x -= width; }
+                if (object.position.y > height) { object.position.y -= height; }
+                accumulator += static_cast<utils::isize_t>(object.position.x) + static_cast<utils::isize_t>(object.position.y);
+            }
+        }
+        utils::doNotOptimize(accumulator);
+        const auto elapsed_us = time::getEpochTimeUs64() - start;
+
+        std::printf("%-24s %8.2f ns/update\n",
+            p_name,
+            1000.0 * elapsed_us / (p_num_objects * p_num_frames));
+    }
+
+    inline void benchmarkMotions()
+    {
+        benchmarkMotion<std::float_t>("float");
+        benchmarkMotion<Fixed<15, 16>>("Fixed<15, 16>");
+        benchmarkMotion<Fixed<15, 16, Overflow::saturate>>("Fixed<15, 16> saturate");
+    }
+
+} // namespace picon::math
@@ -14,27 +14,47 @@ namespace picon::math
         Point<T_Unit> position{};
         Point<T_Unit> size{};
 
-        T_Unit area()
+        constexpr T_Unit area() const
         {
             return size.x * size.y;
         }
 
-        Rect normalized()
+        /// one past the bottom right corner.
+        constexpr Point<T_Unit> end() const
         {
-            if (size.x < 0)
+            return position + size;
+        }
+
+        constexpr bool empty() const
+        {
+            return size.x <= 0 || size.y <= 0;
+        }
+
+        constexpr bool contains(Rect p_rhs) const
+        {
+            return
+                position.x <= p_rhs.position.x && p_rhs.position.x + p_rhs.size.x <= position.x + size.x &&
+                position.y <= p_rhs.position.y && p_rhs.position.y + p_rhs.size.y <= position.y + size.y;
+        }
+
+        constexpr Rect normalized() const
+        {
+            auto rect = *this;
+            if (rect.size.x < 0)
             {
-                position.x += size.x;
-                size.x = -size.x;
+                rect.position.x += rect.size.x;
+                rect.size.x = -rect.size.x;
             }
 
-            if (size.y < 0)
+            if (rect.size.y < 0)
             {
-                position.y += size.y;
-                size.y = -size.y;
+                rect.position.y += rect.size.y;
+                rect.size.y = -rect.size.y;
             }
+            return rect;
         }
 
-        std::optional<Rect> intersect(Rect p_rhs)
+        constexpr std::optional<Rect> intersect(Rect p_rhs) const
         {
             const auto x = std::max(position.x, p_rhs.position.x);
             const auto end_x = std::min(position.x + size.x, p_rhs.position.x + p_rhs.size.x);
@@ -44,8 +64,14 @@ namespace picon::math
             const auto end_y = std::min(position.y + size.y, p_rhs.position.y + p_rhs.size.y);
             if (end_y < y) { return std::nullopt; }
 
-            return {{x, y}, {end_x - x, end_y - y}};
+            return Rect{{x, y}, {end_x - x, end_y - y}};
         }
     };
 
-} // namespace picon::math
\ No newline at end of file
+    static_assert(Rect<int>{{0, 0}, {4, 4}}.intersect({{2, 1}, {4, 2}})->size.x == 2);
+    static_assert(Rect<int>{{0, 0}, {4, 4}}.intersect({{2, 1}, {4, 2}})->size.y == 2);
+    static_assert(!Rect<int>{{0, 0}, {4, 4}}.intersect({{5, 0}, {1, 1}}));
+    static_assert(Rect<int>{{0, 0}, {4, 4}}.intersect({{4, 0}, {1, 1}})->empty());
+    static_assert(Rect<int>{{3, 3}, {-2, -2}}.normalized().position.x == 1);
+
+} // namespace picon::math
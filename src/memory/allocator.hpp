@@ -0,0 +1,39 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+namespace picon::memory
+{
+
+    /// usage of an allocator in bytes, for sizing ram budgets.
+    struct AllocatorStats
+    {
+        std::size_t capacity{};
+        std::size_t used{};
+        std::size_t high_water{};
+        /// allocations that returned nullptr.
+        std::size_t failed{};
+    };
+
+    /// allocate returns nullptr when out of memory, allocators never touch the heap.
+    template <typename T_Allocator>
+    concept Allocator = requires(T_Allocator& r_allocator, void* p_ptr, std::size_t p_size)
+    {
+        { r_allocator.allocate(p_size, p_size) } -> std::same_as<void*>;
+        r_allocator.deallocate(p_ptr, p_size);
+        { r_allocator.getStats() } -> std::same_as<AllocatorStats>;
+    };
+
+    /// round p_offset up to a multiple of p_align, which must be a power of two.
+    constexpr std::size_t alignUp(std::size_t p_offset, std::size_t p_align)
+    {
+        return (p_offset + p_align - 1) & ~(p_align - 1);
+    }
+
+    static_assert(alignUp(0, 8) == 0);
+    static_assert(alignUp(1, 8) == 8);
+    static_assert(alignUp(8, 8) == 8);
+    static_assert(alignUp(9, 4) == 12);
+
+} // namespace picon::memory
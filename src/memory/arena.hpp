@@ -0,0 +1,111 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#if !defined(PICON_FRAME_ARENA_SIZE)
+#define PICON_FRAME_ARENA_SIZE 8192
+#endif
+
+namespace picon::memory
+{
+
+    /// bump allocator over a static buffer.
+    /// memory comes back by rewinding to a marker, resetting, or freeing the
+    /// newest allocation, so there is no fragmentation and allocation is a few adds.
+    /// not thread safe.
+    /// @tparam t_size
+    template <std::size_t t_size>
+    struct Arena
+    {
+        /// allocation offset to rewind to.
+        using Marker = std::size_t;
+
+        constexpr static auto size = t_size;
+
+        alignas(std::max_align_t) std::array<std::byte, t_size> storage{};
+        std::size_t offset{};
+        std::size_t high_water{};
+        std::size_t num_failed{};
+
+        /// nullptr if the arena is full or p_align exceeds max_align_t.
+        constexpr void* allocate(std::size_t p_size, std::size_t p_align = alignof(std::max_align_t)) noexcept
+        {
+            const auto start = alignUp(offset, p_align);
+            if (p_align > alignof(std::max_align_t) || start + p_size > t_size)
+            {
+                ++num_failed;
+                return nullptr;
+            }
+
+            offset = start + p_size;
+            high_water = std::max(high_water, offset);
+            return storage.data() + start;
+        }
+
+        /// frees p_ptr only if it is the newest allocation, everything else waits for rewind or reset.
+        constexpr void deallocate(void* p_ptr, std::size_t p_size) noexcept
+        {
+            if (p_size <= offset && p_ptr == storage.data() + offset - p_size)
+            {
+                offset -= p_size;
+            }
+        }
+
+        constexpr Marker getMarker() const
+        {
+            return offset;
+        }
+
+        /// free everything allocated since p_marker.
+        constexpr void rewind(Marker p_marker)
+        {
+            offset = std::min(offset, p_marker);
+        }
+
+        constexpr void reset()
+        {
+            offset = 0;
+        }
+
+        constexpr AllocatorStats getStats() const
+        {
+            return {
+                .capacity = t_size,
+                .used = offset,
+                .high_water = high_water,
+                .failed = num_failed,
+            };
+        }
+    };
+
+    static_assert(Allocator<Arena<16>>);
+
+    static_assert([](){
+        Arena<32> arena{};
+        const auto a = arena.allocate(3, 1);
+        const auto b = arena.allocate(8, 8);
+        if (a != arena.storage.data() || b != arena.storage.data() + 8) { return false; }
+
+        const auto marker = arena.getMarker();
+        arena.allocate(8, 1);
+        if (arena.allocate(16, 1) != nullptr) { return false; }
+        arena.rewind(marker);
+
+        const auto c = arena.allocate(4, 4);
+        arena.deallocate(c, 4);
+        arena.deallocate(a, 3);
+
+        const auto stats = arena.getStats();
+        return stats.used == 16 && stats.high_water == 24 && stats.failed == 1;
+    }());
+
+
+    /// scratch memory for the current frame, reset at the start of every frame.
+    /// nothing allocated here may be kept across frames.
+    inline constinit Arena<PICON_FRAME_ARENA_SIZE> frame_arena{};
+
+} // namespace picon::memory
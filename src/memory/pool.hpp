@@ -0,0 +1,88 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace picon::memory
+{
+
+    /// fixed size block allocator over a static buffer.
+    /// blocks are handed out in constant time from an intrusive free list,
+    /// suited to many objects of one size such as same-size images.
+    /// not thread safe.
+    /// @tparam t_block_size
+    /// @tparam t_num_blocks
+    template <std::size_t t_block_size, std::size_t t_num_blocks>
+    struct BlockPool
+    {
+        struct alignas(std::max_align_t) Block
+        {
+            std::byte storage[t_block_size];
+        };
+
+        constexpr static auto block_size = t_block_size;
+        constexpr static auto num_blocks = t_num_blocks;
+
+        std::array<Block, t_num_blocks> blocks{};
+        Block* free_list{};
+        std::size_t num_untouched{t_num_blocks};
+
+        std::size_t num_used{};
+        std::size_t high_water{};
+        std::size_t num_failed{};
+
+        /// nullptr if p_size doesn't fit a block or the pool is exhausted.
+        void* allocate(std::size_t p_size, std::size_t p_align = alignof(std::max_align_t)) noexcept
+        {
+            if (p_size > t_block_size || p_align > alignof(Block))
+            {
+                ++num_failed;
+                return nullptr;
+            }
+
+            Block* block{};
+            if (free_list != nullptr)
+            {
+                block = free_list;
+                free_list = *reinterpret_cast<Block**>(block);
+            }
+            else if (num_untouched > 0)
+            {
+                block = &blocks[t_num_blocks - num_untouched--];
+            }
+            else
+            {
+                ++num_failed;
+                return nullptr;
+            }
+
+            ++num_used;
+            high_water = std::max(high_water, num_used);
+            return block;
+        }
+
+        void deallocate(void* p_ptr, std::size_t = 0) noexcept
+        {
+            auto block = static_cast<Block*>(p_ptr);
+            *reinterpret_cast<Block**>(block) = free_list;
+            free_list = block;
+            --num_used;
+        }
+
+        AllocatorStats getStats() const
+        {
+            return {
+                .capacity = t_num_blocks * sizeof(Block),
+                .used = num_used * sizeof(Block),
+                .high_water = high_water * sizeof(Block),
+                .failed = num_failed,
+            };
+        }
+    };
+
+    static_assert(Allocator<BlockPool<16, 1>>);
+
+} // namespace picon::memory
@@ -0,0 +1,22 @@
+#pragma once
+
+#if defined(PICON_PLATFORM_LINUX)
+
+#include <cstdint>
+#include <malloc.h>
+
+// memory info
+
+/// bytes malloc has taken from the os.
+inline std::uint32_t getTotalHeap(void)
+{
+   return mallinfo2().arena;
+}
+
+/// bytes malloc holds but hasn't handed out.
+inline std::uint32_t getFreeHeap(void)
+{
+   return mallinfo2().fordblks;
+}
+
+#endif
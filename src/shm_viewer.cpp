@@ -0,0 +1,89 @@
+#include "config/config.hpp"
+
+#include "drivers/sdl.hpp"
+#include "drivers/shm.hpp"
+#include "graphics/color.hpp"
+#include "time/time.hpp"
+
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+/// reference reader of the frames main.cpp publishes with PICON_SHM_DISPLAY.
+/// usage: picon_shm_viewer [segment name], PICON_SHM or /picon by default.
+
+using namespace picon;
+
+/// must match the display in main.cpp.
+using Format = graphics::color::R4G4B4A4;
+constexpr std::size_t width = 256;
+constexpr std::size_t height = 64;
+
+/// no new frame for this long reopens the segment, in case the producer restarted.
+constexpr std::uint64_t reopen_timeout_us = 1'000'000;
+
+drivers::SdlDriver<Format, width, height> display{.integer_scaling = true};
+drivers::ShmFrameReader<Format, width, height> frames{};
+
+int main(int p_argc, char** p_argv)
+{
+    const char* name = p_argc > 1 ? p_argv[1] : std::getenv("PICON_SHM");
+    if (name == nullptr) { name = "/picon"; }
+
+    display.init();
+
+    std::uint32_t seen_frames{};
+    std::uint64_t last_frame_us{};
+    std::size_t torn_frames{};
+
+    while (true)
+    {
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_EVENT_QUIT)
+            {
+                SDL_Log("%zu torn frames dropped", torn_frames);
+                frames.close();
+                display.deinit();
+                return 0;
+            }
+        }
+
+        if (!frames.isOpen())
+        {
+            if (!frames.open(name))
+            {
+                SDL_Delay(250);
+                continue;
+            }
+            seen_frames = frames.getFrameCounter();
+            last_frame_us = time::getEpochTimeUs64();
+        }
+
+        // short enough to keep the window responsive while the producer idles.
+        const auto counter = frames.waitFrame(seen_frames, 50'000);
+        const auto now = time::getEpochTimeUs64();
+        if (counter == seen_frames)
+        {
+            if (now - last_frame_us > reopen_timeout_us) { frames.close(); }
+            continue;
+        }
+        seen_frames = counter;
+        last_frame_us = now;
+
+        // the copy is the texture upload, a frame the producer overwrote meanwhile isn't presented.
+        auto& back_buffer = display.getBackBuffer();
+        const auto intact = frames.read([&](const auto& p_frame, auto){
+            std::copy(p_frame.begin(), p_frame.end(), back_buffer.begin());
+        });
+
+        if (intact) { display.swapBuffers(); }
+        else { ++torn_frames; }
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "time.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(PICON_PLATFORM_LINUX)
+#include <chrono>
+#include <thread>
+#elif defined(PICON_PLATFORM_PICO)
+#include <pico/time.h>
+#endif
+
+namespace picon::time
+{
+
+    /// sleeps until a deadline with little cpu use and low wake-up error.
+    /// sleeps coarsely up to the calibrated os sleep overshoot plus spin_us before
+    /// the deadline, then spins the rest of the way.
+    /// the overshoot estimate is capped, so a single preempted sleep can't turn
+    /// every later wait into a spin, and decays while waits are too short to sleep.
+    struct FramePacer
+    {
+    public:
+        struct Stats
+        {
+            std::uint64_t waits{};
+            /// wake-up error past the deadline.
+            std::uint64_t late_us_sum{};
+            std::uint64_t late_us_sq_sum{};
+            std::uint64_t late_us_min{UINT64_MAX};
+            std::uint64_t late_us_max{};
+            std::uint64_t slept_us_sum{};
+            std::uint64_t spun_us_sum{};
+
+            std::uint64_t getMeanLateUs() const { return waits > 0 ? late_us_sum / waits : 0; }
+
+            std::uint64_t getLateVarianceUs2() const
+            {
+                if (waits == 0) { return 0; }
+                const auto mean = late_us_sum / waits;
+                return late_us_sq_sum / waits - mean * mean;
+            }
+        };
+
+        /// margin spun before the deadline on top of the overshoot estimate.
+        std::uint64_t spin_us;
+
+        /// hard cap of the overshoot estimate.
+        std::uint64_t max_overshoot_us;
+
+    private:
+        std::uint64_t overshoot_us;
+        Stats stats{};
+
+    public:
+        #if defined(PICON_PLATFORM_LINUX)
+        FramePacer(std::uint64_t p_spin_us = 200, std::uint64_t p_initial_overshoot_us = 1'000, std::uint64_t p_max_overshoot_us = 2'000) :
+        #elif defined(PICON_PLATFORM_PICO)
+        FramePacer(std::uint64_t p_spin_us = 20, std::uint64_t p_initial_overshoot_us = 10, std::uint64_t p_max_overshoot_us = 100) :
+        #endif
+            spin_us{p_spin_us}, max_overshoot_us{p_max_overshoot_us}, overshoot_us{std::min(p_initial_overshoot_us, p_max_overshoot_us)}
+        {}
+
+        void sleepUntilUs(std::uint64_t p_deadline_us)
+        {
+            auto now = getEpochTimeUs64();
+
+            const auto margin = overshoot_us + spin_us;
+            if (p_deadline_us > now + margin)
+            {
+                const auto request = p_deadline_us - now - margin;
+                sleepUs(request);
+
+                const auto woke = getEpochTimeUs64();
+                const auto slept = woke - now;
+                // an overshoot longer than the request itself is preemption, not sleep granularity.
+                calibrate(std::min({slept > request ? slept - request : 0, request, max_overshoot_us}));
+                stats.slept_us_sum += slept;
+                now = woke;
+            }
+            else
+            {
+                // nothing measured, let an estimate that keeps skipping the sleep shrink.
+                calibrate(0);
+            }
+
+            const auto spin_start = now;
+            while (now < p_deadline_us)
+            {
+                #if defined(PICON_PLATFORM_PICO)
+                tight_loop_contents();
+                #endif
+                now = getEpochTimeUs64();
+            }
+            stats.spun_us_sum += now - spin_start;
+
+            const auto late = now - p_deadline_us;
+            stats.waits += 1;
+            stats.late_us_sum += late;
+            stats.late_us_sq_sum += late * late;
+            stats.late_us_min = std::min(stats.late_us_min, late);
+            stats.late_us_max = std::max(stats.late_us_max, late);
+        }
+
+        void sleepForUs(std::uint64_t p_duration_us)
+        {
+            sleepUntilUs(getEpochTimeUs64() + p_duration_us);
+        }
+
+        /// current estimate of how far past a request the os sleep wakes up.
+        const std::uint64_t& getOvershootUs() const
+        {
+            return overshoot_us;
+        }
+
+        const Stats& getStats() const
+        {
+            return stats;
+        }
+
+        void resetStats()
+        {
+            stats = {};
+        }
+
+    private:
+        static void sleepUs(std::uint64_t p_duration_us)
+        #if defined(PICON_PLATFORM_LINUX)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds{p_duration_us});
+        }
+        #elif defined(PICON_PLATFORM_PICO)
+        {
+            // alarm backed, the core waits for events instead of polling the timer.
+            sleep_us(p_duration_us);
+        }
+        #endif
+
+        /// jump up to a larger overshoot at once so the next deadline isn't missed,
+        /// decay slowly towards smaller ones.
+        void calibrate(std::uint64_t p_overshoot_us)
+        {
+            if (p_overshoot_us > overshoot_us)
+            {
+                overshoot_us = p_overshoot_us;
+            }
+            else
+            {
+                overshoot_us -= (overshoot_us - p_overshoot_us) / 16;
+            }
+        }
+    };
+
+} // namespace picon::time
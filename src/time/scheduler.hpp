@@ -0,0 +1,210 @@
+#pragma once
+
+#include "time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace picon::time
+{
+
+    enum class TaskMode : std::uint8_t
+    {
+        /// runs once per due time with the real time since its last run.
+        variable,
+        /// runs with a constant delta of one period, catching up on missed steps.
+        fixed,
+    };
+
+    struct TaskStats
+    {
+        std::uint64_t runs{};
+        /// runs started a full period late or taking longer than a period.
+        std::uint64_t overruns{};
+        /// periods dropped without running to get back on schedule.
+        std::uint64_t skipped{};
+        std::uint64_t max_late_us{};
+        std::uint64_t max_run_us{};
+    };
+
+    /// runs periodic tasks at independent rates off the monotonic clock.
+    /// due tasks are kept in a min-heap on their next due time.
+    /// @tparam t_max_tasks
+    template <std::size_t t_max_tasks>
+    struct Scheduler
+    {
+    public:
+        using TaskFn = void(*)(void* p_context, std::uint64_t p_delta_us);
+
+        /// callables up to this size are stored in the task itself.
+        constexpr static std::size_t fn_storage_size = 2 * sizeof(void*);
+
+        struct Task
+        {
+            TaskFn fn{};
+            void* context{};
+            /// copy of a callable added by value, context points here.
+            alignas(void*) std::array<std::byte, fn_storage_size> fn_storage{};
+            std::uint64_t period_us{};
+            std::uint64_t next_due_us{};
+            std::uint64_t last_run_us{};
+            TaskMode mode{};
+            TaskStats stats{};
+        };
+
+        /// fixed tasks further behind than this many periods skip ahead instead of catching up.
+        /// 0 behaves as 1, the due step always runs.
+        std::size_t max_catch_up{4};
+
+    private:
+        std::array<Task, t_max_tasks> tasks{};
+        std::size_t num_tasks{};
+
+        std::array<std::size_t, t_max_tasks> heap{};
+
+    public:
+        Scheduler() = default;
+        // tasks added by value point into themselves.
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /// add p_fn, called as p_fn(p_context, delta_us), first due immediately.
+        /// p_context must outlive the scheduler.
+        /// returns the task id.
+        std::size_t addTask(std::uint64_t p_period_us, TaskMode p_mode, TaskFn p_fn, void* p_context)
+        {
+            assert(num_tasks < t_max_tasks);
+            assert(p_period_us > 0);
+
+            const auto now = getEpochTimeUs64();
+            const auto id = num_tasks++;
+            tasks[id] = {
+                .fn = p_fn,
+                .context = p_context,
+                .period_us = p_period_us,
+                .next_due_us = now,
+                .last_run_us = now - p_period_us,
+                .mode = p_mode,
+            };
+
+            heap[id] = id;
+            std::push_heap(heap.begin(), heap.begin() + num_tasks, dueLater());
+            return id;
+        }
+
+        /// add a copy of p_fn, called as p_fn(delta_us), first due immediately.
+        /// takes small trivially copyable callables, e.g. lambdas capturing a pointer or two.
+        /// returns the task id.
+        template <typename T_Fn>
+        requires(
+            std::is_trivially_copyable_v<T_Fn> &&
+            sizeof(T_Fn) <= fn_storage_size &&
+            alignof(T_Fn) <= alignof(void*) &&
+            std::is_invocable_v<const T_Fn&, std::uint64_t>
+        )
+        std::size_t addTask(std::uint64_t p_period_us, TaskMode p_mode, T_Fn p_fn)
+        {
+            const auto id = addTask(p_period_us, p_mode, [](void* p_context, std::uint64_t p_delta_us){
+                (*std::launder(static_cast<const T_Fn*>(p_context)))(p_delta_us);
+            }, nullptr);
+
+            auto& task = tasks[id];
+            ::new (task.fn_storage.data()) T_Fn{p_fn};
+            task.context = task.fn_storage.data();
+            return id;
+        }
+
+        /// run every task that is due, earliest first.
+        void run()
+        {
+            const auto now = getEpochTimeUs64();
+
+            while (num_tasks > 0 && tasks[heap[0]].next_due_us <= now)
+            {
+                std::pop_heap(heap.begin(), heap.begin() + num_tasks, dueLater());
+                auto& task = tasks[heap[num_tasks - 1]];
+
+                runTask(task, now);
+
+                std::push_heap(heap.begin(), heap.begin() + num_tasks, dueLater());
+            }
+        }
+
+        /// due time of the earliest task, for sleeping until there is work.
+        std::uint64_t getNextDueUs() const
+        {
+            return num_tasks > 0 ? tasks[heap[0]].next_due_us : getEpochTimeUs64();
+        }
+
+        /// progress from the last step of fixed task p_id to its next, in [0, 1].
+        /// render with state interpolated by this between the last two steps.
+        std::float_t getAlpha(std::size_t p_id) const
+        {
+            const auto& task = tasks[p_id];
+            const auto last_step_us = task.next_due_us - task.period_us;
+            const auto now = getEpochTimeUs64();
+            if (now <= last_step_us) { return 0; }
+            return std::min<std::float_t>(static_cast<std::float_t>(now - last_step_us) / task.period_us, 1);
+        }
+
+        const TaskStats& getStats(std::size_t p_id) const
+        {
+            return tasks[p_id].stats;
+        }
+
+    private:
+        auto dueLater() const
+        {
+            return [this](std::size_t p_a, std::size_t p_b){
+                return tasks[p_a].next_due_us > tasks[p_b].next_due_us;
+            };
+        }
+
+        void runTask(Task& r_task, std::uint64_t p_now)
+        {
+            const auto late = p_now - r_task.next_due_us;
+            const auto behind = late / r_task.period_us;
+            r_task.stats.max_late_us = std::max(r_task.stats.max_late_us, late);
+
+            const auto catch_up = std::max<std::size_t>(max_catch_up, 1);
+            if (r_task.mode == TaskMode::fixed && behind >= catch_up)
+            {
+                const auto skip = behind - catch_up + 1;
+                r_task.next_due_us += skip * r_task.period_us;
+                r_task.stats.skipped += skip;
+            }
+
+            const auto delta = r_task.mode == TaskMode::fixed ? r_task.period_us : p_now - r_task.last_run_us;
+
+            const auto start = getEpochTimeUs64();
+            r_task.fn(r_task.context, delta);
+            const auto run_us = getEpochTimeUs64() - start;
+
+            r_task.last_run_us = p_now;
+            r_task.stats.runs += 1;
+            r_task.stats.max_run_us = std::max(r_task.stats.max_run_us, run_us);
+            if (late >= r_task.period_us || run_us > r_task.period_us)
+            {
+                r_task.stats.overruns += 1;
+            }
+
+            r_task.next_due_us += r_task.period_us;
+
+            // variable tasks drop the slots they missed, fixed tasks run them on the next pop.
+            if (r_task.mode == TaskMode::variable && r_task.next_due_us <= p_now)
+            {
+                const auto skip = (p_now - r_task.next_due_us) / r_task.period_us + 1;
+                r_task.next_due_us += skip * r_task.period_us;
+                r_task.stats.skipped += skip;
+            }
+        }
+    };
+
+} // namespace picon::time
@@ -11,10 +11,11 @@
 namespace picon::time
 {
 
+    /// monotonic microseconds since an unspecified epoch.
     inline std::uint64_t getEpochTimeUs64()
     #if defined(PICON_PLATFORM_LINUX)
     {
-        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     }
     #elif defined(PICON_PLATFORM_PICO)
     {
@@ -75,7 +76,7 @@ namespace picon::time
         std::uint64_t step_delta_us;
 
     private:
-        std::uint64_t last_tick_us{};
+        std::uint64_t last_tick_us{ getEpochTimeUs64() };
         std::uint64_t delta_acc_us{};
 
     public:
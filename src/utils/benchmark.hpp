@@ -0,0 +1,12 @@
+#pragma once
+
+namespace picon::utils
+{
+    /// keeps p_value, and the work that produced it, from being optimized away.
+    /// an empty asm statement that claims to read it, so it costs no instructions.
+    template <typename T_Value>
+    inline void doNotOptimize(const T_Value& p_value)
+    {
+        asm volatile("" : : "r,m"(p_value) : "memory");
+    }
+} // namespace picon::utils
@@ -66,11 +66,21 @@ namespace picon::utils
         }
     }
 
-    /// determines if `resizeBits` should use lookup table
+    /// determines if `resizeBits` should use lookup table.
+    /// a table for small sources beats repeatBits once it takes more than one shift and or.
     /// @tparam t_dst_bits
     /// @tparam t_src_bits
     template <std::size_t t_dst_bits, std::size_t t_src_bits>
-    constexpr bool resize_bits_use_lut{true};
+    constexpr bool resize_bits_use_lut{
+        t_src_bits <= 8 &&
+        (t_dst_bits - t_src_bits) / t_src_bits + ((t_dst_bits - t_src_bits) % t_src_bits > 0) > 1
+    };
+
+    static_assert(!resize_bits_use_lut<8, 4>);
+    static_assert(!resize_bits_use_lut<8, 5>);
+    static_assert(resize_bits_use_lut<8, 1>);
+    static_assert(resize_bits_use_lut<16, 5>);
+    static_assert(!resize_bits_use_lut<32, 16>);
 
     /// lookup table for `resizeBits`
     /// @tparam T_Value
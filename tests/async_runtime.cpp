@@ -0,0 +1,167 @@
+#include "test.hpp"
+
+#include "async/runtime.hpp"
+#include "async/task.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace picon;
+
+namespace
+{
+    async::Task<> recordFrames(std::vector<std::uint64_t>& r_deltas, std::size_t p_frames)
+    {
+        for (std::size_t i = 0; i < p_frames; ++i)
+        {
+            r_deltas.push_back(co_await async::nextFrame());
+        }
+    }
+
+    /// nextFrame resumes once per frame() with that frame's delta, and not on run().
+    void testNextFrame()
+    {
+        async::Runtime runtime{};
+        std::vector<std::uint64_t> deltas{};
+        runtime.spawn(recordFrames(deltas, 2));
+
+        runtime.run();
+        runtime.run();
+        test::check(deltas.empty());
+
+        runtime.frame(16'000);
+        test::check(deltas == std::vector<std::uint64_t>{16'000});
+
+        runtime.frame(17'000);
+        runtime.frame(18'000);
+        test::check(deltas == std::vector<std::uint64_t>{16'000, 17'000});
+    }
+
+
+    async::Task<> sleepThenRecord(std::vector<int>& r_order, int p_id, std::uint64_t p_us)
+    {
+        co_await async::sleepUs(p_us);
+        r_order.push_back(p_id);
+    }
+
+    /// timers wake in deadline order, not spawn order, and never early.
+    void testSleepOrdering()
+    {
+        async::VirtualClock::now_us = 1'000;
+        async::Runtime runtime{};
+        runtime.clock = async::VirtualClock::now;
+
+        std::vector<int> order{};
+        runtime.spawn(sleepThenRecord(order, 0, 300));
+        runtime.spawn(sleepThenRecord(order, 1, 100));
+        runtime.spawn(sleepThenRecord(order, 2, 200));
+        runtime.spawn(sleepThenRecord(order, 3, 100));
+
+        test::check(runtime.getNextWakeUs() == 1'000);
+        runtime.run();
+        test::check(order.empty());
+        test::check(runtime.getNextWakeUs() == 1'100);
+
+        async::VirtualClock::advance(99);
+        runtime.run();
+        test::check(order.empty());
+
+        async::VirtualClock::advance(1);
+        runtime.run();
+        test::check(order == std::vector<int>{1, 3});
+
+        async::VirtualClock::advance(500);
+        runtime.run();
+        test::check(order == std::vector<int>{1, 3, 2, 0});
+        test::check(runtime.getNextWakeUs() == std::numeric_limits<std::uint64_t>::max());
+    }
+
+
+    async::Task<> waitFrame()
+    {
+        co_await async::nextFrame();
+    }
+
+    /// an exhausted frame pool yields empty tasks, spawning them is a no-op,
+    /// and frames of finished tasks are reused.
+    void testPoolExhaustion()
+    {
+        async::Runtime runtime{};
+        const auto used_before = async::frame_pool.num_used;
+        const auto failed_before = async::frame_pool.num_failed;
+        const auto free_frames = async::frame_pool.num_blocks - used_before;
+
+        std::size_t spawned = 0;
+        for (std::size_t i = 0; i < free_frames + 2; ++i)
+        {
+            auto task = waitFrame();
+            if (task.valid()) { ++spawned; }
+            runtime.spawn(std::move(task));
+        }
+
+        test::check(spawned == free_frames);
+        test::check(async::frame_pool.num_used == async::frame_pool.num_blocks);
+        test::check(async::frame_pool.num_failed == failed_before + 2);
+
+        runtime.run();
+        runtime.frame(1);
+        test::check(async::frame_pool.num_used == used_before);
+
+        auto task = waitFrame();
+        test::check(task.valid());
+    }
+
+
+    struct FakeTransferDriver
+    {
+        bool done{false};
+        void (*on_transfer_done)(void* p_context){};
+        void* on_transfer_done_context{};
+
+        bool isTransferDone() const { return done; }
+
+        void complete()
+        {
+            done = true;
+            on_transfer_done(on_transfer_done_context);
+        }
+    };
+
+    async::Task<> awaitTransfer(FakeTransferDriver& r_driver, bool& r_resumed)
+    {
+        co_await async::transferDone(r_driver);
+        r_resumed = true;
+    }
+
+    /// a pending transfer doesn't keep the runtime awake, its completion does.
+    void testTransferSignal()
+    {
+        async::Runtime runtime{};
+        FakeTransferDriver driver{};
+        async::bindTransferDone(runtime, driver);
+
+        bool resumed = false;
+        runtime.spawn(awaitTransfer(driver, resumed));
+        runtime.run();
+        test::check(!resumed);
+        test::check(runtime.getNextWakeUs() == std::numeric_limits<std::uint64_t>::max());
+
+        driver.complete();
+        test::check(runtime.getNextWakeUs() != std::numeric_limits<std::uint64_t>::max());
+        runtime.run();
+        test::check(resumed);
+        test::check(runtime.getNextWakeUs() == std::numeric_limits<std::uint64_t>::max());
+    }
+} // namespace
+
+int main()
+{
+    testNextFrame();
+    testSleepOrdering();
+    testPoolExhaustion();
+    testTransferSignal();
+    return test::failures != 0;
+}
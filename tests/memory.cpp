@@ -0,0 +1,132 @@
+#include "test.hpp"
+
+#include "graphics/color.hpp"
+#include "graphics/image.hpp"
+#include "memory/arena.hpp"
+#include "memory/pool.hpp"
+
+#include <utility>
+
+using namespace picon;
+
+namespace
+{
+    /// freed blocks are handed out again before untouched ones, newest first.
+    void testPoolReuse()
+    {
+        memory::BlockPool<32, 4> pool{};
+        const auto a = pool.allocate(32);
+        const auto b = pool.allocate(16);
+        test::check(a != nullptr && b != nullptr && a != b);
+
+        pool.deallocate(a);
+        pool.deallocate(b);
+        test::check(pool.allocate(8) == b);
+        test::check(pool.allocate(8) == a);
+
+        const auto stats = pool.getStats();
+        test::check(stats.used == 2 * sizeof(decltype(pool)::Block));
+        test::check(stats.high_water == 2 * sizeof(decltype(pool)::Block));
+        test::check(stats.failed == 0);
+    }
+
+    /// an exhausted pool and oversized requests return nullptr and count as failed.
+    void testPoolExhaustion()
+    {
+        memory::BlockPool<16, 2> pool{};
+        test::check(pool.allocate(17) == nullptr);
+
+        const auto a = pool.allocate(16);
+        test::check(pool.allocate(16) != nullptr);
+        test::check(pool.allocate(16) == nullptr);
+
+        auto stats = pool.getStats();
+        test::check(stats.used == stats.capacity);
+        test::check(stats.failed == 2);
+
+        pool.deallocate(a);
+        test::check(pool.allocate(16) == a);
+        stats = pool.getStats();
+        test::check(stats.high_water == stats.capacity);
+        test::check(stats.failed == 2);
+    }
+
+    using GS4Buffer = graphics::ImageBuffer<graphics::color::GS4>;
+
+    /// the buffer frees its block when destroyed, a failed allocation leaves it empty.
+    void testImageBufferFree()
+    {
+        memory::BlockPool<64, 1> pool{};
+        {
+            GS4Buffer image{pool, 8, 8};
+            test::check(image.valid());
+            test::check(image.width == 8 && image.height == 8);
+            test::check(image.at(7, 7).value == 0);
+            test::check(pool.num_used == 1);
+
+            GS4Buffer exhausted{pool, 8, 8};
+            test::check(!exhausted.valid());
+            test::check(exhausted.width == 0 && exhausted.height == 0);
+        }
+        test::check(pool.num_used == 0);
+
+        GS4Buffer too_big{pool, 9, 8};
+        test::check(!too_big.valid());
+        test::check(pool.getStats().failed == 2);
+    }
+
+    /// moves hand the storage over once, assigning over a buffer frees its old storage.
+    void testImageBufferMove()
+    {
+        memory::BlockPool<64, 2> pool{};
+
+        GS4Buffer a{pool, 4, 4};
+        a.at(1, 2) = graphics::color::GS4{0x9};
+        const auto addr = a.data();
+
+        GS4Buffer b{std::move(a)};
+        test::check(!a.valid() && a.width == 0 && a.height == 0);
+        test::check(b.data() == addr && b.width == 4 && b.height == 4);
+        test::check(b.at(1, 2).value == 0x9);
+        test::check(pool.num_used == 1);
+
+        GS4Buffer c{pool, 2, 2};
+        test::check(pool.num_used == 2);
+        c = std::move(b);
+        test::check(!b.valid());
+        test::check(c.data() == addr && c.width == 4);
+        test::check(pool.num_used == 1);
+
+        c = GS4Buffer{};
+        test::check(!c.valid());
+        test::check(pool.num_used == 0);
+    }
+
+    /// from an arena, freeing the newest buffer gives its memory straight back.
+    void testImageBufferArena()
+    {
+        memory::Arena<256> arena{};
+        {
+            GS4Buffer a{arena, 8, 8};
+            {
+                GS4Buffer b{arena, 8, 8};
+                test::check(b.valid());
+                test::check(arena.getStats().used == 128);
+            }
+            test::check(arena.getStats().used == 64);
+            test::check(a.valid());
+        }
+        test::check(arena.getStats().used == 0);
+        test::check(arena.getStats().high_water == 128);
+    }
+} // namespace
+
+int main()
+{
+    testPoolReuse();
+    testPoolExhaustion();
+    testImageBufferFree();
+    testImageBufferMove();
+    testImageBufferArena();
+    return test::failures != 0;
+}
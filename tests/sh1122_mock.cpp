@@ -0,0 +1,166 @@
+#include "test.hpp"
+
+#include "async/runtime.hpp"
+#include "drivers/sh1122.hpp"
+#include "drivers/sh1122_mock.hpp"
+#include "graphics/color.hpp"
+#include "time/time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+using namespace picon;
+
+namespace
+{
+    using Driver = drivers::SH1122Driver<256, 64, drivers::SH1122MockTransport<>>;
+
+    /// step the simulated bus until every queued segment has left it.
+    void drain(Driver& r_display)
+    {
+        while (!r_display.transport.isIdle())
+        {
+            async::VirtualClock::advance(1);
+            r_display.transport.poll();
+        }
+    }
+
+    void drawPattern(Driver& r_display, std::uint8_t p_seed)
+    {
+        auto& frame = r_display.getBackBuffer();
+        for (std::size_t y = 0; y < Driver::height; ++y)
+        {
+            for (std::size_t x = 0; x < Driver::width; ++x)
+            {
+                frame.at(x, y) = graphics::color::GS4{static_cast<std::uint8_t>((x + y * 3 + p_seed) & 0xF)};
+            }
+        }
+    }
+
+    /// the display memory holds the back buffer, two pixels per byte.
+    bool gramMatches(const Driver& p_display)
+    {
+        const auto& frame = p_display.frame_buffer;
+        for (std::size_t y = 0; y < Driver::height; ++y)
+        {
+            for (std::size_t column = 0; column < Driver::columns; ++column)
+            {
+                const auto expected = static_cast<std::uint8_t>(
+                    frame.at(column * 2, y).get<graphics::color::L>() << 4 |
+                    frame.at(column * 2 + 1, y).get<graphics::color::L>());
+                if (p_display.transport.gram.memory[y * Driver::columns + column] != expected) { return false; }
+            }
+        }
+        return true;
+    }
+
+    /// a full frame goes through pack, plan, queue and the simulated bus,
+    /// lands in display memory and takes the bus time of its bytes.
+    void testFullFrame()
+    {
+        async::VirtualClock::now_us = 0;
+        async::Runtime runtime{};
+        runtime.clock = async::VirtualClock::now;
+        static Driver display{};
+        display.transport.clock = async::VirtualClock::now;
+        async::bindTransferDone(runtime, display);
+
+        display.init();
+        drain(display);
+        const auto init_bytes = display.transport.bytes_sent;
+
+        drawPattern(display, 0);
+        const auto start_us = async::VirtualClock::now();
+        test::check(display.swapBuffers());
+        drain(display);
+        const auto frame_us = async::VirtualClock::now() - start_us;
+
+        test::check(gramMatches(display));
+
+        // on the wire: the address of 0, 0, then the packed frame as one data run.
+        const auto& records = display.transport.records;
+        test::check(records.size() >= 2);
+        const auto& address = records[records.size() - 2];
+        const auto& data = records[records.size() - 1];
+        const auto expected_address = drivers::encodeAddress(0, 0);
+        test::check(address.kind == drivers::SH1122SegmentKind::command);
+        test::check(std::equal(address.bytes.begin(), address.bytes.end(), expected_address.begin(), expected_address.end()));
+        test::check(data.kind == drivers::SH1122SegmentKind::data);
+        test::check(data.bytes.size() == Driver::columns * Driver::height);
+        test::check(std::equal(data.bytes.begin(), data.bytes.end(), display.transport.gram.memory.begin()));
+
+        const auto frame_bytes = display.transport.bytes_sent - init_bytes;
+        test::check(frame_bytes == Driver::columns * Driver::height + 4);
+        const auto expected_us = frame_bytes * 8 * 1'000'000 / display.transport.bits_per_second;
+        test::check(frame_us >= expected_us && frame_us <= expected_us + 2);
+
+        // the completion signalled the runtime.
+        test::check(runtime.getNextWakeUs() == async::VirtualClock::now());
+
+        std::printf("sh1122 full frame: %llu bytes, %llu us on the simulated bus\n",
+            static_cast<unsigned long long>(frame_bytes),
+            static_cast<unsigned long long>(frame_us));
+    }
+
+    /// two frames fit in flight, a third swap is dropped without blocking.
+    void testQueueDepth()
+    {
+        async::VirtualClock::now_us = 0;
+        static Driver display{};
+        display.transport.clock = async::VirtualClock::now;
+        display.init();
+        drain(display);
+
+        drawPattern(display, 1);
+        test::check(display.swapBuffers());
+        drawPattern(display, 2);
+        test::check(display.swapBuffers());
+        test::check(!display.isTransferDone());
+
+        drawPattern(display, 3);
+        test::check(!display.swapBuffers());
+        test::check(display.dropped_frames == 1);
+
+        drain(display);
+        test::check(display.isTransferDone());
+
+        // the dropped frame 3 never reached the display, frame 2 did.
+        drawPattern(display, 2);
+        test::check(gramMatches(display));
+    }
+
+    /// host cost of packing and queueing a full frame, the bus itself is simulated.
+    void timeSwap()
+    {
+        static Driver display{};
+        display.transport.clock = async::VirtualClock::now;
+        display.transport.record = false;
+        display.init();
+        drawPattern(display, 0);
+
+        constexpr std::size_t frames = 256;
+        std::uint64_t swap_us{};
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            drain(display);
+            const auto start = time::getEpochTimeUs64();
+            display.swapBuffers();
+            swap_us += time::getEpochTimeUs64() - start;
+        }
+        drain(display);
+        test::check(display.dropped_frames == 0);
+
+        std::printf("sh1122 swapBuffers: %.2f us per full frame on the host\n", static_cast<double>(swap_us) / frames);
+    }
+} // namespace
+
+int main()
+{
+    testFullFrame();
+    testQueueDepth();
+    timeSwap();
+    return test::failures != 0;
+}
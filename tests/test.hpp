@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdio>
+#include <source_location>
+
+namespace picon::test
+{
+
+    /// failed checks of this test executable, main returns non-zero if any.
+    inline int failures{};
+
+    /// count and print a failed p_condition.
+    inline void check(bool p_condition, const std::source_location p_location = std::source_location::current())
+    {
+        if (p_condition) { return; }
+        std::printf("%s:%u: check failed\n", p_location.file_name(), static_cast<unsigned>(p_location.line()));
+        ++failures;
+    }
+
+} // namespace picon::test
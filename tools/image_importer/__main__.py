@@ -1,18 +1,71 @@
 import argparse
+import concurrent.futures
+import hashlib
+import json
 import os
 import pathlib
 import typing
 
+import numpy
+import numpy.typing
 import PIL.Image
+import PIL.ImageDraw
+import PIL.ImageFont
 
 from dataclasses import dataclass
 from textwrap import dedent
 
 
-ImageFormat = typing.Literal["GS4", "GS4A1", "R5G6B5", "R5G5B5A1"]
+ImageFormat = typing.Literal["GS4", "GS4A1", "R5G6B5", "R5G5B5A1", "I4", "I8"]
+DitherMode = typing.Literal["none", "ordered", "error-diffusion"]
+
+# bits per channel, in PIL band order. alpha is always the 4th / 2nd band.
+FORMAT_CHANNEL_BITS: dict[ImageFormat, tuple[int, ...]] = {
+    "GS4": (4,),
+    "GS4A1": (4, 1),
+    "R5G6B5": (5, 6, 5),
+    "R5G5B5A1": (5, 5, 5, 1),
+    "I4": (4,),
+    "I8": (8,),
+}
+
+FORMAT_HAS_ALPHA: dict[ImageFormat, bool] = {
+    "GS4": False,
+    "GS4A1": True,
+    "R5G6B5": False,
+    "R5G5B5A1": True,
+    "I4": False,
+    "I8": False,
+}
+
+# indexed formats are emitted with a <name>_palette in PALETTE_FORMAT.
+INDEXED_FORMATS: tuple[ImageFormat, ...] = ("I4", "I8")
+PALETTE_FORMAT = "R8G8B8A8"
+
+# sub-byte formats are emitted as PackedImageData, several pixels per byte, the first in the high bits.
+PACKED_FORMATS: tuple[ImageFormat, ...] = ("I4",)
+
+# matches picon::graphics::color::bayer_4x4.
+BAYER_4X4 = (
+    0,  8,  2,  10,
+    12, 4,  14, 6,
+    3,  11, 1,  9,
+    15, 7,  13, 5,
+)
+
+# uint8 pixels as [height, width, channels].
+Pixels = numpy.typing.NDArray[numpy.uint8]
+
+# generated sources of one image, cached by the hash of its png and the importer.
+CACHE_DIR_NAME = ".image_importer_cache"
 
 PICON_HPP_INCLUDES = [
     "graphics/image.hpp",
+    "graphics/palette.hpp",
+]
+
+PICON_FONT_HPP_INCLUDES = [
+    "graphics/font.hpp",
 ]
 
 PICON_IMAGE_NAMESPACE = "picon::graphics"
@@ -23,7 +76,19 @@ class ImportOptions:
     input_dir: pathlib.PurePath
     output_dir: pathlib.PurePath
     format: ImageFormat
+    dither: DitherMode
     images_namespace: str
+    fonts_dir: pathlib.PurePath | None
+    fonts_namespace: str
+    jobs: int | None
+    cache: bool
+
+
+@dataclass
+class ImportedImage:
+    """the declarations and definitions of one image, in images.hpp / images.cpp order."""
+    hpp: str
+    cpp: str
 
 
 def main() -> None:
@@ -34,7 +99,15 @@ def main() -> None:
         "-f", "--format",
         choices=typing.get_args(ImageFormat),
         default="GS4")
+    _ = parser.add_argument(
+        "-d", "--dither",
+        choices=typing.get_args(DitherMode),
+        default="none")
     _ = parser.add_argument("--images-namespace", default="assets::images")
+    _ = parser.add_argument("--fonts-dir", default=None)
+    _ = parser.add_argument("--fonts-namespace", default="assets::fonts")
+    _ = parser.add_argument("-j", "--jobs", type=int, default=None, help="worker processes, defaults to the cpu count")
+    _ = parser.add_argument("--no-cache", action="store_true", help="reimport every image")
     args = parser.parse_args()
     # exits if parser cannot parse
 
@@ -42,53 +115,136 @@ def main() -> None:
         input_dir=pathlib.PurePath(typing.cast(str, args.input_dir)),
         output_dir=pathlib.PurePath(typing.cast(str, args.output_dir)),
         format=typing.cast(ImageFormat, args.format),
-        images_namespace=typing.cast(str, args.images_namespace)
+        dither=typing.cast(DitherMode, args.dither),
+        images_namespace=typing.cast(str, args.images_namespace),
+        fonts_dir=pathlib.PurePath(typing.cast(str, args.fonts_dir)) if args.fonts_dir else None,
+        fonts_namespace=typing.cast(str, args.fonts_namespace),
+        jobs=typing.cast(int | None, args.jobs),
+        cache=not typing.cast(bool, args.no_cache),
     )
 
     os.makedirs(options.output_dir, exist_ok=True)
 
     generate_images_source(options)
+    generate_fonts_source(options)
 
 
 def generate_images_source(options: ImportOptions) -> None:
+    """
+    imports every png in the input dir, in name order.
+    unchanged images are read back from the cache, the rest are imported in parallel.
+    """
+    image_paths = sorted(
+        pathlib.PurePath(options.input_dir).joinpath(s)
+        for s in os.listdir(options.input_dir)
+        if pathlib.PurePath(s).suffix.lower() == ".png")
+
+    cache_dir = pathlib.Path(options.output_dir).joinpath(CACHE_DIR_NAME)
+    importer_hash = hashlib.sha256(pathlib.Path(__file__).read_bytes()).hexdigest()
+    keys = [make_cache_key(importer_hash, options, path) for path in image_paths]
+
+    imported: dict[str, ImportedImage] = {}
+    if options.cache:
+        for key in keys:
+            if (cached := load_cached_image(cache_dir, key)) is not None:
+                imported[key] = cached
+
+    missing = [(key, path) for key, path in zip(keys, image_paths) if key not in imported]
+    if len(missing) > 1 and options.jobs != 1:
+        with concurrent.futures.ProcessPoolExecutor(max_workers=options.jobs) as executor:
+            results = executor.map(import_image, [path for _, path in missing], [options.format] * len(missing), [options.dither] * len(missing))
+            imported.update(zip((key for key, _ in missing), results))
+    else:
+        imported.update((key, import_image(path, options.format, options.dither)) for key, path in missing)
+
+    if options.cache:
+        save_cached_images(cache_dir, {key: imported[key] for key, _ in missing}, set(keys))
+
     with open(options.output_dir.joinpath("images.hpp"), "w") as hpp_file:
         with open(file=options.output_dir.joinpath("images.cpp"), mode="w") as cpp_file:
             print(make_images_hpp_prefix(options), file=hpp_file)
             print(make_images_cpp_prefix(options), file=cpp_file)
 
-            image_paths = [pathlib.PurePath(options.input_dir).joinpath(s) for s in os.listdir(options.input_dir)]
-            for image_path in image_paths:
-                if image_path.suffix.lower() != ".png":
-                    continue
-                image = PIL.Image.open(image_path)
-                match options.format:
-                    case "GS4": image = image.convert("L")
-                    case "GS4A1": image = image.convert("LA")
-                    case "R5G6B5": image = image.convert("RGB")
-                    case "R5G5B5A1": image = image.convert("RGBA")
-                name = image_path.stem
-
-                image_data_decl = make_image_data_declaration(options.format, name, image)
-                image_data_defn = make_image_data_definition(options.format, name, image)
-                print("extern " + image_data_decl + ";", file=hpp_file)
-                print(image_data_decl + " = " + image_data_defn + ";", file=cpp_file)
-
-                image_decl = make_image_definition(options.format, name, image)
-                print(image_decl + ";", file=hpp_file)
+            for key in keys:
+                _ = hpp_file.write(imported[key].hpp)
+                _ = cpp_file.write(imported[key].cpp)
 
             print(make_images_hpp_suffix(options), file=hpp_file)
             print(make_images_cpp_suffix(options), file=cpp_file)
 
 
+def import_image(image_path: pathlib.PurePath, format: ImageFormat, dither: DitherMode) -> ImportedImage:
+    """converts one png, runs in a worker process."""
+    image = PIL.Image.open(image_path)
+    match format:
+        case "GS4": image = image.convert("L")
+        case "GS4A1": image = image.convert("LA")
+        case "R5G6B5": image = image.convert("RGB")
+        case "R5G5B5A1": image = image.convert("RGBA")
+        case "I4" | "I8": image = image.convert("RGBA")
+    name = image_path.stem
+
+    hpp = ""
+    cpp = ""
+    palette = None
+    if format in INDEXED_FORMATS:
+        pixels, palette = quantize_indexed_image(format, dither, image)
+        palette_decl = make_palette_declaration(name, palette)
+        hpp += "extern " + palette_decl + ";\n"
+        cpp += palette_decl + " = " + make_palette_definition(palette) + ";\n"
+    else:
+        pixels = quantize_image(format, dither, image)
+
+    image_data_decl = make_image_data_declaration(format, name, image)
+    hpp += "extern " + image_data_decl + ";\n"
+    cpp += image_data_decl + " = " + make_image_data_definition(format, name, image, pixels) + ";\n"
+
+    hpp += make_image_definition(format, name, image) + ";\n"
+    hpp += make_image_opaque_definition(format, name, pixels, palette) + ";\n"
+
+    return ImportedImage(hpp, cpp)
+
+
+def make_cache_key(importer_hash: str, options: ImportOptions, image_path: pathlib.PurePath) -> str:
+    """hash of everything an image's output depends on: the importer, the options and the png itself."""
+    key = hashlib.sha256()
+    key.update(importer_hash.encode())
+    key.update(f"{options.format}:{options.dither}:{image_path.stem}".encode())
+    key.update(pathlib.Path(image_path).read_bytes())
+    return key.hexdigest()
+
+
+def load_cached_image(cache_dir: pathlib.Path, key: str) -> ImportedImage | None:
+    try:
+        with open(cache_dir.joinpath(key + ".json")) as cache_file:
+            entry = typing.cast(dict[str, str], json.load(cache_file))
+        return ImportedImage(entry["hpp"], entry["cpp"])
+    except (OSError, ValueError, KeyError):
+        return None
+
+
+def save_cached_images(cache_dir: pathlib.Path, images: dict[str, ImportedImage], keep: set[str]) -> None:
+    """stores newly imported images and drops entries no current image uses."""
+    cache_dir.mkdir(parents=True, exist_ok=True)
+    for key, image in images.items():
+        with open(cache_dir.joinpath(key + ".json"), "w") as cache_file:
+            json.dump({"hpp": image.hpp, "cpp": image.cpp}, cache_file)
+
+    for entry in cache_dir.glob("*.json"):
+        if entry.stem not in keep:
+            entry.unlink(missing_ok=True)
+
+
 def make_images_hpp_prefix(options: ImportOptions) -> str:
-    return dedent(f"""
-    #pragma once
+    return "\n\n".join([
+        "#pragma once",
+        make_includes(PICON_HPP_INCLUDES),
+        f"namespace {options.images_namespace}\n{{",
+    ])
 
-    { "\n".join(f"#include \"{f}\"" for f in PICON_HPP_INCLUDES) }
 
-    namespace {options.images_namespace}
-    {{
-    """).strip()
+def make_includes(includes: list[str]) -> str:
+    return "\n".join(f"#include \"{f}\"" for f in includes)
 
 
 def make_images_hpp_suffix(_options: ImportOptions) -> str:
@@ -108,37 +264,378 @@ def make_images_cpp_suffix(_options: ImportOptions) -> str:
     return "}"
 
 
-def make_image_data_definition(format: ImageFormat, _name: str, image: PIL.Image.Image) -> str:
-    image_data = ""
-    for y in range(image.height):
-        image_data += "\n    "
-        for x in range(image.width):
-            image_data += make_color_str(format, typing.cast(tuple[int], image.getpixel((x,y)))) + ", "
+def quantize_image(format: ImageFormat, dither: DitherMode, image: PIL.Image.Image) -> Pixels:
+    """
+    reduces each pixel's 8 bit channels to the bit depths of format.
+    color channels are truncated, ordered dithered or error diffused, alpha is always truncated.
+    """
+    channel_bits = FORMAT_CHANNEL_BITS[format]
+    alpha_index = len(channel_bits) - 1 if FORMAT_HAS_ALPHA[format] else -1
+
+    source = image_pixels(image).astype(numpy.int32)
+    result = numpy.empty(source.shape, dtype=numpy.uint8)
+
+    if dither == "ordered":
+        bayer = numpy.array(BAYER_4X4, dtype=numpy.int32).reshape(4, 4)
+        ys, xs = numpy.indices((image.height, image.width))
+        threshold = (bayer[ys % 4, xs % 4] * 2 + 1) * 255 // 32
+
+    for c, bits in enumerate(channel_bits):
+        max_value = (1 << bits) - 1
+        if dither == "none" or c == alpha_index:
+            result[..., c] = source[..., c] >> (8 - bits)
+
+        elif dither == "ordered":
+            result[..., c] = (source[..., c] * max_value + threshold) // 255
+
+        elif dither == "error-diffusion":
+            result[..., c] = diffuse_error(source[..., c], max_value)
+
+    return result
+
+
+def diffuse_error(channel: numpy.typing.NDArray[numpy.int32], max_value: int) -> list[list[int]]:
+    """
+    floyd-steinberg, serpentine scan.
+    every pixel depends on the error of the previous one, so this stays a scalar loop, on lists, which python walks faster than arrays.
+    """
+    height, width = channel.shape
+    error = typing.cast(list[list[float]], channel.astype(numpy.float64).tolist())
+    result = [[0] * width for _ in range(height)]
+    for y in range(height):
+        forward = y % 2 == 0
+        xs = range(width) if forward else range(width - 1, -1, -1)
+        step = 1 if forward else -1
+        for x in xs:
+            value = min(max(error[y][x], 0.0), 255.0)
+            level = round(value * max_value / 255)
+            result[y][x] = level
+            diff = value - level * 255 / max_value
+            for dx, dy, weight in ((step, 0, 7), (-step, 1, 3), (0, 1, 5), (step, 1, 1)):
+                nx, ny = x + dx, y + dy
+                if 0 <= nx < width and ny < height:
+                    error[ny][nx] += diff * weight / 16
+    return result
+
+
+def quantize_indexed_image(
+    format: ImageFormat, dither: DitherMode, image: PIL.Image.Image
+) -> tuple[Pixels, list[tuple[int, int, int, int]]]:
+    """
+    median cut quantization of an RGBA image into a palette of up to 2^bits colors.
+    if any pixel is transparent, index 0 is reserved as the transparent entry.
+    """
+    max_colors = 1 << FORMAT_CHANNEL_BITS[format][0]
+    transparent = numpy.asarray(image.getchannel("A")) < 128
+    has_transparency = bool(transparent.any())
+    first_index = 1 if has_transparency else 0
+
+    quantized = image.convert("RGB").quantize(
+        colors=max_colors - first_index,
+        method=PIL.Image.Quantize.MEDIANCUT,
+        dither=PIL.Image.Dither.FLOYDSTEINBERG if dither == "error-diffusion" else PIL.Image.Dither.NONE)
+
+    indices = numpy.asarray(quantized).astype(numpy.int32)
+    opaque_indices = indices[~transparent]
+    used = int(opaque_indices.max()) + 1 if opaque_indices.size else 0
+    pixels = numpy.where(transparent, 0, indices + first_index).astype(numpy.uint8)[..., numpy.newaxis]
+
+    raw_palette = quantized.getpalette() or []
+    palette: list[tuple[int, int, int, int]] = [(0, 0, 0, 0)] if has_transparency else []
+    palette += [(raw_palette[i * 3], raw_palette[i * 3 + 1], raw_palette[i * 3 + 2], 255) for i in range(used)]
+
+    return pixels, palette
+
+
+def make_palette_declaration(name: str, palette: list[tuple[int, int, int, int]]) -> str:
+    return f"const {PICON_IMAGE_NAMESPACE}::Palette<const {PICON_COLOR_NAMESPACE}::{PALETTE_FORMAT}, {len(palette)}> {name}_palette"
+
+
+def make_palette_definition(palette: list[tuple[int, int, int, int]]) -> str:
+    palette_data = "".join(f"\n    {{{r}, {g}, {b}, {a}}}, " for r, g, b, a in palette)
+    return f"{{ std::array<const {PICON_COLOR_NAMESPACE}::{PALETTE_FORMAT}, {len(palette)}>{{ {{ {palette_data} }} }} }}"
+
+
+def image_pixels(image: PIL.Image.Image) -> Pixels:
+    """the pixels of image as [height, width, channels], single band images included."""
+    pixels = numpy.asarray(image, dtype=numpy.uint8)
+    return pixels[..., numpy.newaxis] if pixels.ndim == 2 else pixels
+
+
+def make_image_data_definition(format: ImageFormat, name: str, image: PIL.Image.Image, pixels: Pixels) -> str:
+    if format in PACKED_FORMATS:
+        return make_packed_image_data_definition(format, name, image, pixels)
+
+    # one printf style pattern per row, formatting a row at a time in c.
+    pixel_pattern = "{" + ", ".join(["%d"] * pixels.shape[2]) + "}, "
+    row_pattern = "\n    " + pixel_pattern * image.width
+    image_data = "".join(row_pattern % tuple(row) for row in pixels.reshape(image.height, -1).tolist())
 
     return f"{{ std::array<const {PICON_COLOR_NAMESPACE}::{format}, {image.width * image.height}>{{ {{ {image_data} }} }} }}"
     
 
+def make_packed_image_data_definition(format: ImageFormat, _name: str, image: PIL.Image.Image, pixels: Pixels) -> str:
+    """rows padded to whole bytes, matching picon::graphics::PackedImageData."""
+    bits = FORMAT_CHANNEL_BITS[format][0]
+    pixels_per_byte = 8 // bits
+    stride = (image.width + pixels_per_byte - 1) // pixels_per_byte
+
+    padded = numpy.zeros((image.height, stride * pixels_per_byte), dtype=numpy.uint8)
+    padded[:, :image.width] = pixels[..., 0]
+    packed = numpy.zeros((image.height, stride), dtype=numpy.uint8)
+    for i in range(pixels_per_byte):
+        packed |= padded[:, i::pixels_per_byte] << (8 - bits * (i + 1))
+
+    row_pattern = "\n    " + "%d, " * stride
+    image_data = "".join(row_pattern % tuple(row) for row in packed.tolist())
+
+    return f"{{ std::array<std::uint8_t, {stride * image.height}>{{ {{ {image_data} }} }} }}"
+
+
 def make_image_data_declaration(format: ImageFormat, name: str, image: PIL.Image.Image) -> str:
-    image_data = ""
-    for y in range(image.height):
-        image_data += "\n    "
-        for x in range(image.width):
-            image_data += make_color_str(format, typing.cast(tuple[int], image.getpixel((x,y)))) + ", "
-    return f"const {PICON_IMAGE_NAMESPACE}::ImageData<const {PICON_COLOR_NAMESPACE}::{format}, {image.width}, {image.height}> {name}_data"
+    data_type = "PackedImageData" if format in PACKED_FORMATS else "ImageData"
+    return f"const {PICON_IMAGE_NAMESPACE}::{data_type}<const {PICON_COLOR_NAMESPACE}::{format}, {image.width}, {image.height}> {name}_data"
 
 
 def make_image_definition(format: ImageFormat, name: str, _image: PIL.Image.Image) -> str:
-    return f"constexpr {PICON_IMAGE_NAMESPACE}::Image<const {PICON_COLOR_NAMESPACE}::{format}> {name} {{{name}_data}}"
+    image_type = "PackedImage" if format in PACKED_FORMATS else "Image"
+    return f"constexpr {PICON_IMAGE_NAMESPACE}::{image_type}<const {PICON_COLOR_NAMESPACE}::{format}> {name} {{{name}_data}}"
 
 
-def make_color_str(format: ImageFormat, value: tuple[int, ...]) -> str:
-    if isinstance(value, int):
-        value = tuple([value])
-    match format:
-        case "GS4": return f"{{{value[0] >> 4}}}"
-        case "GS4A1": return f"{{{value[0] >> 4}, {value[1] >> 7}}}"
-        case "R5G6B5": return f"{{{value[0] >> 3}, {value[1] >> 2}, {value[2] >> 3}}}"
-        case "R5G5B5A1": return f"{{{value[0] >> 3}, {value[1] >> 3}, {value[2] >> 3}, {value[3] >> 7}}}"
+def make_image_opaque_definition(
+    format: ImageFormat, name: str, pixels: Pixels, palette: list[tuple[int, int, int, int]] | None
+) -> str:
+    """<name>_opaque is true when every pixel has full alpha, which lets draws beneath the image be skipped."""
+    if palette is not None:
+        palette_alpha = numpy.array([a for _, _, _, a in palette] or [0], dtype=numpy.uint8)
+        opaque = bool((palette_alpha[pixels[..., 0]] == 255).all())
+    elif FORMAT_HAS_ALPHA[format]:
+        max_alpha = (1 << FORMAT_CHANNEL_BITS[format][-1]) - 1
+        opaque = bool((pixels[..., -1] == max_alpha).all())
+    else:
+        opaque = True
+    return f"constexpr bool {name}_opaque = {'true' if opaque else 'false'}"
+
+
+
+@dataclass
+class FontGlyph:
+    codepoint: int
+    mask: PIL.Image.Image | None
+    offset_x: int
+    offset_y: int
+    advance: int
+    atlas_x: int = 0
+
+
+@dataclass
+class BakedFont:
+    name: str
+    line_height: int
+    ascent: int
+    glyphs: list[FontGlyph]
+
+
+def generate_fonts_source(options: ImportOptions) -> None:
+    """
+    bakes every font described by a *.json file in the fonts dir.
+    json keys:
+        source: path to a .bdf or .ttf/.otf, relative to the json file.
+        size: pixel size, ttf/otf only.
+        first / last: inclusive codepoint range, defaults to printable ascii.
+        threshold: 0-255 coverage cutoff for ttf/otf masks, defaults to 128.
+    """
+    fonts: list[BakedFont] = []
+    if options.fonts_dir is not None and os.path.isdir(options.fonts_dir):
+        for spec_name in sorted(os.listdir(options.fonts_dir)):
+            spec_path = options.fonts_dir.joinpath(spec_name)
+            if spec_path.suffix.lower() != ".json":
+                continue
+            with open(spec_path) as spec_file:
+                spec = typing.cast(dict[str, typing.Any], json.load(spec_file))
+            fonts.append(bake_font(spec_path, spec))
+
+    with open(options.output_dir.joinpath("fonts.hpp"), "w") as hpp_file:
+        with open(options.output_dir.joinpath("fonts.cpp"), "w") as cpp_file:
+            print(make_fonts_hpp_prefix(options), file=hpp_file)
+            print(make_fonts_cpp_prefix(options), file=cpp_file)
+
+            for font in fonts:
+                atlas_width, atlas_height, atlas = pack_font_atlas(font)
+                stride = (atlas_width + 7) // 8
+
+                atlas_decl = f"const std::array<const std::uint8_t, {len(atlas)}> {font.name}_atlas"
+                glyphs_decl = f"const std::array<const {PICON_IMAGE_NAMESPACE}::Glyph, {len(font.glyphs)}> {font.name}_glyphs"
+
+                print("extern " + atlas_decl + ";", file=hpp_file)
+                print("extern " + glyphs_decl + ";", file=hpp_file)
+                print(make_font_definition(font, stride) + ";", file=hpp_file)
+
+                print(atlas_decl + " = " + make_font_atlas_definition(atlas, stride) + ";", file=cpp_file)
+                print(glyphs_decl + " = " + make_font_glyphs_definition(font) + ";", file=cpp_file)
+
+            print(make_images_hpp_suffix(options), file=hpp_file)
+            print(make_images_cpp_suffix(options), file=cpp_file)
+
+
+def bake_font(spec_path: pathlib.PurePath, spec: dict[str, typing.Any]) -> BakedFont:
+    source = spec_path.parent.joinpath(typing.cast(str, spec["source"]))
+    first = typing.cast(int, spec.get("first", 0x20))
+    last = typing.cast(int, spec.get("last", 0x7E))
+    name = spec_path.stem
+
+    if source.suffix.lower() == ".bdf":
+        return bake_bdf_font(name, source, first, last)
+
+    size = typing.cast(int, spec["size"])
+    threshold = typing.cast(int, spec.get("threshold", 128))
+    return bake_ttf_font(name, source, size, first, last, threshold)
+
+
+def bake_bdf_font(name: str, path: pathlib.PurePath, first: int, last: int) -> BakedFont:
+    ascent = 0
+    descent = 0
+    glyphs: dict[int, FontGlyph] = {}
+
+    with open(path) as bdf_file:
+        lines = iter(bdf_file.read().splitlines())
+
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        match fields[0]:
+            case "FONT_ASCENT": ascent = int(fields[1])
+            case "FONT_DESCENT": descent = int(fields[1])
+            case "STARTCHAR":
+                codepoint = -1
+                advance = 0
+                bbx = (0, 0, 0, 0)
+                rows: list[int] = []
+                for char_line in lines:
+                    char_fields = char_line.split()
+                    if not char_fields:
+                        continue
+                    match char_fields[0]:
+                        case "ENCODING": codepoint = int(char_fields[1])
+                        case "DWIDTH": advance = int(char_fields[1])
+                        case "BBX": bbx = typing.cast(tuple[int, int, int, int], tuple(int(f) for f in char_fields[1:5]))
+                        case "BITMAP":
+                            for bitmap_line in lines:
+                                if bitmap_line.strip() == "ENDCHAR":
+                                    break
+                                rows.append(int(bitmap_line.strip(), 16))
+                            break
+                        case _: pass
+
+                if codepoint < first or codepoint > last:
+                    continue
+
+                width, height, bbx_x, bbx_y = bbx
+                row_bits = ((width + 7) // 8) * 8
+                mask = PIL.Image.new("1", (max(width, 1), max(height, 1)), 0)
+                for y, row in enumerate(rows[:height]):
+                    for x in range(width):
+                        if (row >> (row_bits - 1 - x)) & 1:
+                            mask.putpixel((x, y), 1)
+
+                glyphs[codepoint] = FontGlyph(
+                    codepoint=codepoint,
+                    mask=mask if width > 0 and height > 0 else None,
+                    offset_x=bbx_x,
+                    offset_y=ascent - (bbx_y + height),
+                    advance=advance)
+            case _: pass
+
+    return BakedFont(name, ascent + descent, ascent, fill_font_range(glyphs, first, last))
+
+
+def bake_ttf_font(name: str, path: pathlib.PurePath, size: int, first: int, last: int, threshold: int) -> BakedFont:
+    font = PIL.ImageFont.truetype(str(path), size)
+    ascent, descent = font.getmetrics()
+    glyphs: dict[int, FontGlyph] = {}
+
+    for codepoint in range(first, last + 1):
+        char = chr(codepoint)
+        advance = round(font.getlength(char))
+        left, top, right, bottom = font.getbbox(char, anchor="la")
+        mask = None
+        if right > left and bottom > top:
+            coverage = PIL.Image.new("L", (right - left, bottom - top), 0)
+            PIL.ImageDraw.Draw(coverage).text((-left, -top), char, font=font, fill=255, anchor="la")
+            mask = coverage.point(lambda v: 1 if v >= threshold else 0, mode="1")
+        glyphs[codepoint] = FontGlyph(codepoint, mask, left, top, advance)
+
+    return BakedFont(name, ascent + descent, ascent, fill_font_range(glyphs, first, last))
+
+
+def fill_font_range(glyphs: dict[int, FontGlyph], first: int, last: int) -> list[FontGlyph]:
+    return [glyphs.get(c, FontGlyph(c, None, 0, 0, 0)) for c in range(first, last + 1)]
+
+
+def pack_font_atlas(font: BakedFont) -> tuple[int, int, list[int]]:
+    """packs glyph masks left to right into a single 1-bit strip, rows MSB first."""
+    atlas_width = 0
+    atlas_height = 0
+    for glyph in font.glyphs:
+        if glyph.mask is None:
+            continue
+        glyph.atlas_x = atlas_width
+        atlas_width += glyph.mask.width
+        atlas_height = max(atlas_height, glyph.mask.height)
+
+    stride = (atlas_width + 7) // 8
+    atlas = [0] * (stride * atlas_height)
+    for glyph in font.glyphs:
+        if glyph.mask is None:
+            continue
+        for y in range(glyph.mask.height):
+            for x in range(glyph.mask.width):
+                if glyph.mask.getpixel((x, y)):
+                    ax = glyph.atlas_x + x
+                    atlas[y * stride + ax // 8] |= 0x80 >> (ax % 8)
+
+    return atlas_width, atlas_height, atlas
+
+
+def make_fonts_hpp_prefix(options: ImportOptions) -> str:
+    return "\n\n".join([
+        "#pragma once",
+        make_includes(PICON_FONT_HPP_INCLUDES),
+        "#include <array>\n#include <cstdint>",
+        f"namespace {options.fonts_namespace}\n{{",
+    ])
+
+
+def make_fonts_cpp_prefix(options: ImportOptions) -> str:
+    return dedent(f"""
+    #include "fonts.hpp"
+
+    namespace {options.fonts_namespace}
+    {{
+    """).strip()
+
+
+def make_font_atlas_definition(atlas: list[int], stride: int) -> str:
+    atlas_data = ""
+    for i in range(0, len(atlas), max(stride, 1)):
+        atlas_data += "\n    " + "".join(f"0x{b:02x}, " for b in atlas[i:i + stride])
+    return f"{{ {{ {atlas_data} }} }}"
+
+
+def make_font_glyphs_definition(font: BakedFont) -> str:
+    glyph_data = ""
+    for glyph in font.glyphs:
+        width, height = (glyph.mask.width, glyph.mask.height) if glyph.mask is not None else (0, 0)
+        glyph_data += f"\n    {{{glyph.atlas_x}, 0, {width}, {height}, {glyph.offset_x}, {glyph.offset_y}, {glyph.advance}}}, "
+    return f"{{ {{ {glyph_data} }} }}"
+
+
+def make_font_definition(font: BakedFont, stride: int) -> str:
+    return (
+        f"constexpr {PICON_IMAGE_NAMESPACE}::Font {font.name} {{ "
+        f"{stride}, {font.name}_atlas, {font.name}_glyphs, {font.glyphs[0].codepoint if font.glyphs else 0}, "
+        f"{font.line_height}, {font.ascent} }}")
 
 
 if __name__ == "__main__":